@@ -2,6 +2,7 @@
 #include <vector>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <memory>
 #include <stdexcept>
 #include <sstream>
@@ -11,669 +12,9158 @@
 #include <iomanip>
 #include <numeric>
 #include <cmath>
+#include <limits>
+#include <cstring>
+#include <cerrno>
+#include <fstream>
+#include <tuple>
+#include <thread>
+#include <mutex>
+#include <deque>
+#include <list>
+#include <queue>
+#include <functional>
+#include <type_traits>
+#include <typeinfo>
+#include <atomic>
 #include <chrono>  // 用于基准测试计时
+#include <new>
+#include <cstdlib>
+
+// 磁带镜像文件映射（POSIX）
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+// SIMD扫描内核所需的平台头文件
+#if defined(__x86_64__) || defined(__i386__)
+#define TAPE_SCAN_X86 1
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#define TAPE_SCAN_NEON 1
+#include <arm_neon.h>
+#endif
+
+// 主机CPU计时与内存分配计数（编译时开关，CMake选项TAPE_INSTRUMENTATION）
+// 设备计数器（寻道、读写量）属于模拟结果，始终统计，不受此开关影响
+// 关闭时计时语句位于if (false)中：仍做类型检查，但不生成代码
+#ifndef TAPE_INSTRUMENTATION
+#define TAPE_INSTRUMENTATION 1
+#endif
+#if TAPE_INSTRUMENTATION
+#define TAPE_COUNT(...) do { __VA_ARGS__; } while (0)
+#else
+#define TAPE_COUNT(...) do { if (false) { __VA_ARGS__; } } while (0)
+#endif
+
+// 当前线程的主机内存分配计数（TAPE_INSTRUMENTATION开启时替换全局operator new统计；对齐分配不计入）
+struct AllocationCounts {
+    uint64_t allocations = 0;
+    uint64_t bytes = 0;
+};
+AllocationCounts thread_allocation_counts();
 
 // 关键修复：在main函数前声明run_benchmarks
 int run_benchmarks();
 
+// 生成并保存磁带镜像
+int run_image_save(int argc, char** argv);
+
+// 批量调度对比
+int run_batch_comparison(int argc, char** argv);
+
+// 并行参数扫描
+int run_parameter_sweep(int argc, char** argv);
+
+// 索引容器基准测试
+int run_container_benchmark(int argc, char** argv);
+int run_placement_comparison(int argc, char** argv);
+int run_seek_model_comparison(int argc, char** argv);
+int run_cache_comparison(int argc, char** argv);
+int run_index_cache_comparison(int argc, char** argv);
+int run_incremental_benchmark(int argc, char** argv);
+int run_parallel_build_benchmark(int argc, char** argv);
+int run_filter_comparison(int argc, char** argv);
+int run_library_simulation(int argc, char** argv);
+int run_event_engine_check(int argc, char** argv);
+int run_workload_comparison(int argc, char** argv);
+int run_trace_save(int argc, char** argv);
+int run_latency_report(int argc, char** argv);
+int run_counter_export(int argc, char** argv);
+int run_benchmark_suite(int argc, char** argv);
+int run_specialized_comparison(int argc, char** argv);
+int run_index_format_report(int argc, char** argv);
+int run_learned_comparison(int argc, char** argv);
+int run_ingest_comparison(int argc, char** argv);
+int run_packing_comparison(int argc, char** argv);
+
 // 磁带块结构
 struct TapeBlock {
     uint64_t block_id;       // 块ID
     std::vector<uint8_t> data; // 块数据
     bool is_index_block;     // 是否为索引块
     
-    TapeBlock(uint64_t id, const std::vector<uint8_t>& d, bool is_index = false)
-        : block_id(id), data(d), is_index_block(is_index) {}
+    TapeBlock(uint64_t id, std::vector<uint8_t> d, bool is_index = false)
+        : block_id(id), data(std::move(d)), is_index_block(is_index) {}
 };
 
-// 磁带设备模拟器
-class TapeDevice {
+// 块只读视图（零拷贝读取，指向设备内部存储，下一次写入前有效）
+struct TapeBlockView {
+    uint64_t block_id;       // 块ID
+    const uint8_t* data;     // 块数据指针（合成块为nullptr，需通过load_payload获取）
+    size_t size;             // 块数据长度
+    bool is_index_block;     // 是否为索引块
+};
+
+// 块数据字节池：连续缓冲区，按偏移分配，不做零初始化；clear后保留容量供下次复用
+class PayloadArena {
 private:
-    // 成员变量顺序调整：与构造函数初始化列表顺序一致（修复警告）
-    size_t block_size;              // 块大小(字节)
-    double read_speed;              // 读取速度(字节/秒)
-    double write_speed;             // 写入速度(字节/秒)
-    double seek_time_per_block;     // 块间寻道时间(秒)
-    size_t current_position;        // 当前位置（移到最后，与初始化顺序一致）
-    std::vector<TapeBlock> blocks;  // 磁带块集合
+    std::unique_ptr<uint8_t[]> buffer;  // 底层缓冲区
+    size_t used = 0;                    // 已分配字节数
+    size_t capacity = 0;                // 缓冲区容量
     
 public:
-    TapeDevice(size_t block_size = 4096, 
-              double read_speed = 1024 * 1024,  // 1MB/s
-              double write_speed = 512 * 1024,   // 512KB/s
-              double seek_time = 0.01);          // 10ms per block
+    // 分配size字节，返回其偏移；之前返回的指针可能因扩容失效，偏移始终有效
+    uint64_t allocate(size_t size);
     
-    // 写入块
-    double write_block(const TapeBlock& block);
+    // 预留容量
+    void reserve(size_t bytes);
     
-    // 读取当前块
-    std::pair<TapeBlock, double> read_current_block();
+    void clear() { used = 0; }
+    size_t size() const { return used; }
+    uint8_t* data(uint64_t offset) { return buffer.get() + offset; }
+    const uint8_t* data(uint64_t offset) const { return buffer.get() + offset; }
+};
+
+// 块数据存放模式
+enum class PayloadMode {
+    Materialized,  // 块数据实际存放在字节池中
+    Synthetic      // 数据块只记录长度，内容在需要时由种子生成
+};
+
+// 由种子生成伪随机数据（splitmix64，每步产生8个字节）
+void fill_synthetic_payload(uint8_t* dst, size_t size, uint64_t seed);
+
+// 线性扫描内核：在[begin, end)中查找第一个ID等于target的数据块，未找到返回end
+using BlockScanKernel = size_t (*)(const uint64_t* ids, const uint8_t* flags,
+                                   size_t begin, size_t end, uint64_t target);
+
+// 按运行时CPU特性分派到AVX-512/AVX2/NEON/标量内核
+size_t find_data_block(const uint64_t* ids, const uint8_t* flags,
+                       size_t begin, size_t end, uint64_t target);
+
+// 当前选用的扫描内核名称
+const char* scan_kernel_name();
+
+// 只读基础段：块存储前部不可变的列数据，指向外部内存（如映射的磁带镜像）
+struct BlockSegment {
+    const uint64_t* block_ids = nullptr;    // 块ID列
+    const uint8_t* index_flags = nullptr;   // 索引块标志列
+    const uint32_t* sizes = nullptr;        // 数据长度列
+    const uint64_t* offsets = nullptr;      // 该块之前的数据总字节数
+    const uint8_t* payload = nullptr;       // 数据区
+    size_t count = 0;                       // 块数量
+    uint64_t total_bytes = 0;               // 数据总字节数
+    std::shared_ptr<const void> owner;      // 保持底层内存有效
+};
+
+// 列式块存储：元数据按列连续存放，块数据集中在一个字节池中按偏移寻址
+// 存储由只读基础段和可追加的尾段组成，位置[0, base.count)位于基础段
+class TapeBlockStore {
+private:
+    BlockSegment base;                  // 只读基础段
+    std::vector<uint64_t> block_ids;    // 块ID列
+    std::vector<uint8_t> index_flags;   // 索引块标志列（0/1）
+    std::vector<uint32_t> sizes;        // 数据长度列
+    std::vector<uint64_t> offsets;      // 该块之前的数据总字节数（实体化模式下减去基础段字节数即字节池偏移）
+    PayloadArena payload;               // 数据字节池
+    uint64_t total_bytes = 0;           // 全部块的数据总字节数
+    PayloadMode mode = PayloadMode::Materialized;
+    uint64_t synthetic_seed = 0;        // 合成模式的全局种子
+    std::unordered_map<size_t, uint64_t> resident_offsets;  // 合成模式下实际存放数据的块：位置 -> 数据偏移（基础段内为数据区偏移）
     
-    // 移动到指定块
-    double seek_to_block(size_t block_index);
+    // 追加一行元数据
+    void push_metadata(uint64_t id, size_t size, bool is_index);
     
-    // 向前移动n个块
-    double move_forward(size_t n = 1);
+public:
+    // 追加块，返回块位置
+    size_t append(uint64_t id, const uint8_t* data, size_t size, bool is_index);
     
-    // 向后移动n个块
-    double move_backward(size_t n = 1);
+    // 原地追加块：分配size字节并返回可写指针（下一次追加前有效），由调用方填充数据
+    uint8_t* emplace(uint64_t id, size_t size, bool is_index);
     
-    // 获取当前位置
-    size_t get_current_position() const;
+    // 追加合成块：只记录长度，内容由种子和块位置决定（仅合成模式）
+    size_t append_synthetic(uint64_t id, size_t size, bool is_index);
     
-    // 获取块数量
-    size_t get_block_count() const;
+    // 按预计块数和数据总量预留空间
+    void reserve(size_t block_count, size_t payload_bytes);
     
-    // 获取指定位置的块
-    const TapeBlock& get_block(size_t index) const;
+    // 设置数据存放模式（仅允许在存储为空时设置）
+    void set_payload_mode(PayloadMode new_mode, uint64_t seed);
+    PayloadMode payload_mode() const { return mode; }
     
-    // 重置磁带
-    void reset();
+    // 读取块数据：实际存放的直接复制，合成块按种子生成
+    void copy_payload(size_t index, std::vector<uint8_t>& out) const;
     
-    // 获取块大小
-    size_t get_block_size() const { return block_size; }
+    // 合成块的种子
+    uint64_t block_seed(size_t index) const;
+    
+    // 清空存储（同时释放基础段）
+    void clear();
+    
+    // 保存为磁带镜像文件
+    void save_image(const std::string& path, size_t block_size) const;
+    
+    // 以只读映射方式打开磁带镜像，镜像内容成为基础段（不复制），返回镜像记录的块大小
+    size_t open_image(const std::string& path);
+    
+    // 以另一存储的全部块作为只读基础段（不复制）；source须只含一个段，且在本存储使用期间不得修改
+    void share_from(const TapeBlockStore& source);
+    
+    size_t size() const { return base.count + block_ids.size(); }
+    uint64_t block_id(size_t index) const {
+        return index < base.count ? base.block_ids[index] : block_ids[index - base.count];
+    }
+    bool is_index(size_t index) const {
+        return (index < base.count ? base.index_flags[index] : index_flags[index - base.count]) != 0;
+    }
+    size_t data_size(size_t index) const {
+        return index < base.count ? base.sizes[index] : sizes[index - base.count];
+    }
+    const uint8_t* data(size_t index) const;
+    TapeBlockView view(size_t index) const {
+        return {block_id(index), data(index), data_size(index), is_index(index)};
+    }
+    
+    // 在[begin, end)中查找第一个ID为target的数据块（只访问ID列和标志列），未找到返回end
+    size_t find_data_block(size_t begin, size_t end, uint64_t target) const;
+    
+    // 位置[0, index)内所有块的数据总字节数（index可取size()）
+    uint64_t bytes_before(size_t index) const {
+        if (index < base.count) {
+            return base.offsets[index];
+        }
+        index -= base.count;
+        return index < offsets.size() ? offsets[index] : total_bytes;
+    }
 };
 
-// 索引策略基类
-class IndexStrategy {
+// 磁带设备模拟器
+// 磁带物理坐标
+struct TapeCoordinate {
+    size_t position = 0;      // 物理块位置（沿写入顺序）
+    size_t wrap = 0;          // 磁道号（wrap）
+    size_t longitudinal = 0;  // 纵向位置（0为磁带开头）
+    
+    // 偶数磁道从磁带开头向末尾写入，奇数磁道反向
+    bool forward() const { return wrap % 2 == 0; }
+};
+
+// 磁带几何：物理块位置到(磁道, 纵向位置)的蛇形映射；blocks_per_wrap为0时整盘是一条正向磁道
+class TapeGeometry {
+private:
+    size_t blocks_per_wrap;
+    
 public:
-    virtual ~IndexStrategy() = default;
+    explicit TapeGeometry(size_t blocks_per_wrap = 0) : blocks_per_wrap(blocks_per_wrap) {}
     
-    // 构建索引
-    virtual double build_index(TapeDevice& tape) = 0;
+    TapeCoordinate locate(size_t position) const;
     
-    // 查找数据块
-    virtual std::pair<size_t, double> find_block(TapeDevice& tape, uint64_t data_id) = 0;
+    // 不小于position的第一个磁道起点（分区按磁道对齐）
+    size_t align_to_wrap(size_t position) const;
+    
+    size_t get_blocks_per_wrap() const { return blocks_per_wrap; }
+};
+
+// 寻道模型：按物理坐标计算磁头定位耗时（不含数据传输）
+// 向前移动不超过stream_window()块时视为顺序经过（不停带），否则为一次定位
+class SeekModel {
+public:
+    virtual ~SeekModel() = default;
+    
+    // 从from移动到to的耗时：前进不超过stream_window()时按顺序经过计费，否则为一次定位
+    double seek_time(const TapeCoordinate& from, const TapeCoordinate& to) const;
+    
+    // 顺序读取时从from前进到to（to.position >= from.position）的额外耗时，对区间的任意切分可加
+    virtual double pass_time(const TapeCoordinate& from, const TapeCoordinate& to) const = 0;
+    
+    // 一次定位（启停、卷绕、换向）的耗时
+    virtual double locate_time(const TapeCoordinate& from, const TapeCoordinate& to) const = 0;
+    
+    // 视为顺序经过的最大前进距离（块）
+    virtual size_t stream_window() const = 0;
     
-    // 获取策略名称
     virtual std::string get_name() const = 0;
     
-    // 获取索引统计信息
-    virtual std::string get_stats() const = 0;
+    // 复制模型（供设备游标使用）
+    virtual std::unique_ptr<SeekModel> clone() const = 0;
 };
 
-// 无索引策略
-class NoIndexStrategy : public IndexStrategy {
-public:
-    // 修复警告：使用[[maybe_unused]]标记未使用参数
-    double build_index([[maybe_unused]] TapeDevice& tape) override;
-    std::pair<size_t, double> find_block(TapeDevice& tape, uint64_t data_id) override;
-    std::string get_name() const override;
-    std::string get_stats() const override;
+// 按静态类型调用寻道模型：Model为具体模型时限定调用（不经虚函数表，可内联），为SeekModel时按虚函数调用
+// 调用方须保证模型的实际类型恰为Model
+template <typename Model>
+struct SeekModelOps {
+    static double pass_time(const SeekModel& model, const TapeCoordinate& from, const TapeCoordinate& to) {
+        if constexpr (std::is_same_v<Model, SeekModel>) {
+            return model.pass_time(from, to);
+        } else {
+            return static_cast<const Model&>(model).Model::pass_time(from, to);
+        }
+    }
+    
+    static double locate_time(const SeekModel& model, const TapeCoordinate& from, const TapeCoordinate& to) {
+        if constexpr (std::is_same_v<Model, SeekModel>) {
+            return model.locate_time(from, to);
+        } else {
+            return static_cast<const Model&>(model).Model::locate_time(from, to);
+        }
+    }
+    
+    static size_t stream_window(const SeekModel& model) {
+        if constexpr (std::is_same_v<Model, SeekModel>) {
+            return model.stream_window();
+        } else {
+            return static_cast<const Model&>(model).Model::stream_window();
+        }
+    }
+    
+    static double seek_time(const SeekModel& model, const TapeCoordinate& from, const TapeCoordinate& to) {
+        if (to.position >= from.position && to.position - from.position <= stream_window(model)) {
+            return pass_time(model, from, to);
+        }
+        return locate_time(model, from, to);
+    }
 };
 
-// 固定间隔索引策略
-class FixedIntervalIndexStrategy : public IndexStrategy {
+inline double SeekModel::seek_time(const TapeCoordinate& from, const TapeCoordinate& to) const {
+    return SeekModelOps<SeekModel>::seek_time(*this, from, to);
+}
+
+// 线性模型：任意移动都按距离 × 每块耗时计算（原有模型）
+class LinearSeekModel final : public SeekModel {
 private:
-    size_t interval;  // 索引间隔
-    std::unordered_map<uint64_t, size_t> index_map;  // 数据ID到块位置的映射
+    double time_per_block;
     
 public:
-    FixedIntervalIndexStrategy(size_t interval = 10);
+    explicit LinearSeekModel(double time_per_block = 0.01) : time_per_block(time_per_block) {}
     
-    double build_index(TapeDevice& tape) override;
-    std::pair<size_t, double> find_block(TapeDevice& tape, uint64_t data_id) override;
-    std::string get_name() const override;
-    std::string get_stats() const override;
+    double pass_time(const TapeCoordinate& from, const TapeCoordinate& to) const override {
+        return (to.position - from.position) * time_per_block;
+    }
+    double locate_time(const TapeCoordinate& from, const TapeCoordinate& to) const override;
+    size_t stream_window() const override { return std::numeric_limits<size_t>::max(); }
+    std::string get_name() const override { return "linear"; }
+    std::unique_ptr<SeekModel> clone() const override { return std::make_unique<LinearSeekModel>(*this); }
 };
 
-// 分层索引策略
-class HierarchicalIndexStrategy : public IndexStrategy {
+// 分段模型参数（秒）
+struct PiecewiseSeekParams {
+    double ramp_time = 0.3;                 // 一次定位的启停（加速+减速）开销
+    double reversal_time = 0.5;             // 反向移动的额外开销
+    size_t locate_threshold = 512;          // 不超过该距离时以定位速度逼近，超出部分高速卷绕
+    double locate_time_per_block = 0.002;   // 定位阶段每块耗时
+    double wind_time_per_block = 0.0001;    // 高速卷绕阶段每块耗时
+    double stream_time_per_block = 0.001;   // 顺序经过时每块的额外耗时（块间隙）
+    size_t stream_window = 16;              // 不停带直接读过的最大前进距离
+};
+
+// 分段模型：启停开销 + 高速卷绕 + 定位逼近，反向移动额外计费（按物理位置计算，不区分磁道）
+class PiecewiseSeekModel : public SeekModel {
+protected:
+    PiecewiseSeekParams params;
+    
+    // 磁带纵向移动distance块的卷绕+定位耗时
+    double travel_time(size_t distance) const;
+    
+public:
+    explicit PiecewiseSeekModel(const PiecewiseSeekParams& params = PiecewiseSeekParams()) : params(params) {}
+    
+    double pass_time(const TapeCoordinate& from, const TapeCoordinate& to) const override {
+        return (to.position - from.position) * params.stream_time_per_block;
+    }
+    double locate_time(const TapeCoordinate& from, const TapeCoordinate& to) const override;
+    size_t stream_window() const override { return params.stream_window; }
+    std::string get_name() const override { return "piecewise"; }
+    std::unique_ptr<SeekModel> clone() const override { return std::make_unique<PiecewiseSeekModel>(*this); }
+};
+
+// 蛇形磁道模型：在设备几何（TapeGeometry）给出的磁道和纵向坐标上计费
+// 定位时纵向移动按分段模型计费，换道与纵向移动同时进行；顺序读到磁道末尾需停带换向
+class SerpentineSeekModel final : public PiecewiseSeekModel {
 private:
-    size_t level1_interval;  // 一级索引间隔
-    size_t level2_interval;  // 二级索引间隔
-    std::unordered_map<uint64_t, std::pair<size_t, size_t>> index_map;  // 数据ID到(一级块, 二级块)的映射
+    double wrap_switch_time;  // 磁头换道耗时
     
 public:
-    HierarchicalIndexStrategy(size_t level1 = 100, size_t level2 = 10);
+    explicit SerpentineSeekModel(double wrap_switch_time = 0.05,
+                                 const PiecewiseSeekParams& params = PiecewiseSeekParams());
     
-    double build_index(TapeDevice& tape) override;
-    std::pair<size_t, double> find_block(TapeDevice& tape, uint64_t data_id) override;
-    std::string get_name() const override;
-    std::string get_stats() const override;
+    double pass_time(const TapeCoordinate& from, const TapeCoordinate& to) const override;
+    double locate_time(const TapeCoordinate& from, const TapeCoordinate& to) const override;
+    std::string get_name() const override { return "serpentine"; }
+    std::unique_ptr<SeekModel> clone() const override { return std::make_unique<SerpentineSeekModel>(*this); }
 };
 
-// 索引策略工厂
-class IndexStrategyFactory {
+// 寻道模型工厂：type取 "linear" / "piecewise" / "serpentine"，linear使用seek_time_per_block
+class SeekModelFactory {
 public:
-    static std::unique_ptr<IndexStrategy> create_strategy(const std::string& type, 
-                                                         size_t param1 = 0, 
-                                                         size_t param2 = 0);
+    static std::unique_ptr<SeekModel> create_seek_model(const std::string& type, double seek_time_per_block = 0.01);
 };
 
-// 模拟结果结构
-struct SimulationResult {
-    std::string strategy_name;
-    double index_build_time;      // 索引构建时间
-    double average_access_time;   // 平均访问时间
-    size_t total_seeks;           // 总寻道次数
-    size_t total_blocks_accessed; // 总访问块数
-    double total_access_time;     // 总访问时间
+// 驱动器缓冲区的块缓存接口：按块键记录驻留的块及其字节数，容量以字节计
+class BlockCache {
+public:
+    virtual ~BlockCache() = default;
+    
+    // 查找块，命中时更新其访问记录
+    virtual bool lookup(uint64_t key) = 0;
+    
+    // 是否驻留（不更新访问记录）
+    virtual bool contains(uint64_t key) const = 0;
+    
+    // 插入未驻留的块，必要时淘汰；大于容量的块不缓存
+    virtual void insert(uint64_t key, size_t bytes) = 0;
+    
+    virtual void clear() = 0;
+    virtual size_t used_bytes() const = 0;
+    virtual std::string get_name() const = 0;
+    
+    // 创建参数相同的空缓存（供设备游标使用）
+    virtual std::unique_ptr<BlockCache> clone_empty() const = 0;
 };
 
-// 磁带模拟器
-class TapeSimulator {
+// LRU缓存
+class LruBlockCache final : public BlockCache {
 private:
-    TapeDevice tape_device;
-    std::unique_ptr<IndexStrategy> current_strategy;
-    std::vector<SimulationResult> results;
-    
-    // 生成测试数据
-    void generate_test_data(size_t block_count, double data_size_ratio = 0.5);
+    size_t capacity;
+    size_t used = 0;
+    std::list<std::pair<uint64_t, size_t>> order;  // (键, 字节数)，表头为最近使用
+    std::unordered_map<uint64_t, std::list<std::pair<uint64_t, size_t>>::iterator> entries;
     
 public:
-    TapeSimulator(size_t block_size = 4096);
+    explicit LruBlockCache(size_t capacity_bytes) : capacity(capacity_bytes) {}
     
-    // 设置索引策略
-    void set_strategy(std::unique_ptr<IndexStrategy> strategy);
+    bool lookup(uint64_t key) override;
+    bool contains(uint64_t key) const override { return entries.count(key) != 0; }
+    void insert(uint64_t key, size_t bytes) override;
+    void clear() override;
+    size_t used_bytes() const override { return used; }
+    std::string get_name() const override { return "lru"; }
+    std::unique_ptr<BlockCache> clone_empty() const override { return std::make_unique<LruBlockCache>(capacity); }
+};
+
+// ARC缓存（按字节计量的自适应替换缓存）：T1为只访问过一次的块，T2为多次访问的块，
+// B1/B2为最近从T1/T2淘汰的块键（幽灵表），幽灵命中时调整T1的目标字节数target
+class ArcBlockCache final : public BlockCache {
+private:
+    using List = std::list<std::pair<uint64_t, size_t>>;
+    enum Which : uint8_t { T1, T2, B1, B2 };
+    struct Entry {
+        Which list;
+        List::iterator it;
+    };
     
-    // 运行模拟
-    SimulationResult run_simulation(size_t block_count, 
-                                   const std::vector<uint64_t>& query_ids,
-                                   bool generate_new_data = true);
+    size_t capacity;
+    double target = 0.0;      // T1的目标字节数
+    List lists[4];            // 各表，表头为最近使用
+    size_t bytes[4] = {0, 0, 0, 0};
+    std::unordered_map<uint64_t, Entry> entries;
     
-    // 运行对比模拟
-    std::vector<SimulationResult> run_comparison(size_t block_count,
-                                                const std::vector<uint64_t>& query_ids,
-                                                const std::vector<std::string>& strategy_types);
+    // 把键移到指定表的表头
+    void move_to(uint64_t key, Which list);
     
-    // 打印结果
-    void print_results() const;
+    // 丢弃指定表表尾的键
+    void drop_lru(Which list);
+    
+    // 为bytes字节腾出空间：按target从T1或T2淘汰到对应幽灵表
+    void replace(size_t needed, bool in_b2);
+    
+public:
+    explicit ArcBlockCache(size_t capacity_bytes) : capacity(capacity_bytes) {}
+    
+    bool lookup(uint64_t key) override;
+    bool contains(uint64_t key) const override;
+    void insert(uint64_t key, size_t bytes) override;
+    void clear() override;
+    size_t used_bytes() const override { return bytes[T1] + bytes[T2]; }
+    std::string get_name() const override { return "arc"; }
+    std::unique_ptr<BlockCache> clone_empty() const override { return std::make_unique<ArcBlockCache>(capacity); }
+};
 
-    // 基准测试：测量索引构建时间（返回毫秒）
-    double benchmark_index_build(size_t block_count) {
-        generate_test_data(block_count);
-        auto start = std::chrono::high_resolution_clock::now();
-        current_strategy->build_index(tape_device);
-        auto end = std::chrono::high_resolution_clock::now();
-        return std::chrono::duration<double, std::milli>(end - start).count();
-    }
+// 设备缓存配置
+struct DeviceCacheConfig {
+    std::string policy = "none";              // "none" / "lru" / "arc"
+    size_t capacity_bytes = 0;                // 缓冲区容量
+    size_t read_ahead_blocks = 0;             // 未命中读取后继续预读的块数
+    double buffer_bandwidth = 256.0 * 1024 * 1024;  // 缓冲区带宽(字节/秒)
+};
 
-    // 基准测试：测量查询性能（返回毫秒）
-    double benchmark_queries(const std::vector<uint64_t>& query_ids) {
-        auto start = std::chrono::high_resolution_clock::now();
-        for (uint64_t id : query_ids) {
-            current_strategy->find_block(tape_device, id);
-        }
-        auto end = std::chrono::high_resolution_clock::now();
-        return std::chrono::duration<double, std::milli>(end - start).count();
-    }
+// 设备缓存统计
+struct DeviceCacheStats {
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t read_ahead_blocks = 0;  // 预读进缓存的块数
 };
 
-// TapeDevice 实现
-TapeDevice::TapeDevice(size_t block_size, double read_speed, double write_speed, double seek_time)
-    : block_size(block_size), read_speed(read_speed), write_speed(write_speed),
-      seek_time_per_block(seek_time), current_position(0) {}  // 初始化顺序与成员声明顺序一致
+// 设备热路径计数器（缓存命中的块也计入读取，预读不计入）
+struct DeviceIoStats {
+    size_t seeks = 0;               // 磁带实际重新定位的次数
+    uint64_t seek_distance = 0;     // 重新定位经过的物理块数之和
+    size_t direction_reversals = 0; // 磁带运动方向（按物理块序）反转的次数
+    size_t blocks_read = 0;         // 交给主机的块数
+    uint64_t bytes_read = 0;        // 交给主机的字节数
+    size_t blocks_written = 0;      // 写入的块数（含索引分区块与穿插块）
+    uint64_t bytes_written = 0;     // 写入的字节数
+};
 
-double TapeDevice::write_block(const TapeBlock& block) {
-    blocks.push_back(block);
-    double time = block.data.size() / write_speed;
-    return time;
-}
+// 块缓存工厂：policy取 "lru" / "arc"，"none"返回nullptr
+class BlockCacheFactory {
+public:
+    static std::unique_ptr<BlockCache> create_cache(const std::string& policy, size_t capacity_bytes);
+};
 
-std::pair<TapeBlock, double> TapeDevice::read_current_block() {
-    if (current_position >= blocks.size()) {
-        throw std::out_of_range("Position out of range");
-    }
-    
-    const TapeBlock& block = blocks[current_position];
-    double time = block.data.size() / read_speed;
-    return {block, time};
-}
+// 块所在区域：磁带开头的索引分区、数据分区、穿插在数据分区中的索引块
+// 物理顺序为：索引分区（固定容量）→ 数据分区，穿插块紧跟在其锚点数据块之后
+enum class TapeRegion : uint8_t {
+    IndexPartition,
+    Data,
+    Interleaved
+};
 
-double TapeDevice::seek_to_block(size_t block_index) {
-    if (block_index >= blocks.size()) {
-        throw std::out_of_range("Block index out of range");
+// 块地址：区域及区域内的位置
+struct BlockAddress {
+    TapeRegion region = TapeRegion::Data;
+    size_t position = std::string::npos;
+};
+
+class TapeDevice;
+
+// 追加写入观察者：TapeDevice在数据分区末尾写入一个块后通知，position为该块位置
+// 返回观察者处理该块产生的模拟耗时（例如写入新的索引块），计入本次写入
+class BlockAppendObserver {
+public:
+    virtual ~BlockAppendObserver() = default;
+    virtual double on_append(TapeDevice& tape, const TapeBlockView& block, size_t position) = 0;
+};
+
+class TapeDevice {
+private:
+    // 成员变量顺序调整：与构造函数初始化列表顺序一致（修复警告）
+    size_t block_size;              // 块大小(字节)
+    double read_speed;              // 读取速度(字节/秒)
+    double write_speed;             // 写入速度(字节/秒)
+    double seek_time_per_block;     // 块间寻道时间(秒)，线性寻道模型的参数
+    size_t current_position;        // 当前位置（移到最后，与初始化顺序一致）
+    TapeBlockStore blocks;          // 磁带块集合（列式存储）
+    std::unique_ptr<SeekModel> seek_model;         // 寻道模型（默认线性）
+    TapeGeometry geometry;                         // 磁道几何（默认单条正向磁道）
+    DeviceCacheConfig cache_config;                // 缓冲区配置
+    std::unique_ptr<BlockCache> cache;             // 缓冲区（nullptr表示不缓存）
+    DeviceCacheStats cache_stats;                  // 缓冲区统计
+    DeviceIoStats io_stats;                        // 读取与寻道统计
+    int motion_direction = 0;                      // 上一次磁带运动方向（1正向，-1反向，0未运动）
+    TapeRegion head_region = TapeRegion::Data;     // 磁带实际所在区域（缓存命中时磁带不移动）
+    size_t head_position = 0;                      // 磁带实际所在位置
+    TapeRegion current_region = TapeRegion::Data;  // 磁头所在区域，current_position为区域内位置
+    size_t index_partition_capacity = 0;           // 索引分区容量（块），0表示不分区
+    TapeBlockStore index_partition;                // 索引分区中的块
+    TapeBlockStore interleaved_blocks;             // 穿插在数据分区中的索引块
+    std::vector<size_t> interleaved_anchors;       // 各穿插块之前紧邻的数据块位置（非降序）
+    std::vector<BlockAppendObserver*> append_observers;  // 追加写入观察者（不随游标复制）
+    
+    // 通知观察者数据分区末尾新写入的块
+    double notify_append();
+    
+    const TapeBlockStore& region_store(TapeRegion region) const;
+    
+    // 块在磁带上的物理位置（以块为单位），寻道耗时按其几何坐标计算
+    // 数据分区从索引分区之后的第一个磁道起点开始
+    size_t physical_position(TapeRegion region, size_t position) const;
+    
+    TapeCoordinate coordinate_of(TapeRegion region, size_t position) const {
+        return geometry.locate(physical_position(region, position));
     }
     
-    size_t distance = std::abs(static_cast<int64_t>(block_index) - static_cast<int64_t>(current_position));
-    double time = distance * seek_time_per_block;
-    current_position = block_index;
-    return time;
-}
-
-double TapeDevice::move_forward(size_t n) {
-    size_t new_pos = current_position + n;
-    if (new_pos >= blocks.size()) {
-        new_pos = blocks.size() - 1;
+    // 缓存键：区域在高8位，位置在低56位
+    static uint64_t cache_key(TapeRegion region, size_t position) {
+        return (static_cast<uint64_t>(region) << 56) | position;
     }
     
-    return seek_to_block(new_pos);
-}
-
-double TapeDevice::move_backward(size_t n) {
-    size_t new_pos = (current_position >= n) ? current_position - n : 0;
-    return seek_to_block(new_pos);
-}
-
-size_t TapeDevice::get_current_position() const {
-    return current_position;
-}
-
-size_t TapeDevice::get_block_count() const {
-    return blocks.size();
-}
-
-const TapeBlock& TapeDevice::get_block(size_t index) const {
-    if (index >= blocks.size()) {
-        throw std::out_of_range("Block index out of range");
+    // 把磁带从实际位置移到逻辑位置（current_region, current_position）
+    double move_tape_to_current() { return move_tape_to_current_as<SeekModel>(); }
+    
+    // 寻道与读取的共同实现：Model/Cache为寻道模型与缓冲区的静态类型（见SeekModelOps/BlockCacheOps），
+    // SeekModel/BlockCache为按虚函数调用的通用路径，NoBlockCache表示未设置缓冲区；不做边界检查
+    template <typename Model>
+    double move_tape_to_current_as();
+    template <typename Model, typename Cache>
+    double seek_to_as(TapeRegion region, size_t position);
+    template <typename Model, typename Cache>
+    std::pair<TapeBlockView, double> view_current_block_as();
+    
+    // 记录一次磁带运动的方向（用于统计方向反转）
+    void note_motion(int direction);
+    
+    // 记录写入的块
+    void note_write(size_t bytes) {
+        io_stats.blocks_written++;
+        io_stats.bytes_written += bytes;
     }
-    return blocks[index];
-}
-
-void TapeDevice::reset() {
-    blocks.clear();
-    current_position = 0;
-}
-
-// NoIndexStrategy 实现
-double NoIndexStrategy::build_index(TapeDevice& tape) {
-    return 0.0; // 无索引，构建时间为0
-}
-
-std::pair<size_t, double> NoIndexStrategy::find_block(TapeDevice& tape, uint64_t data_id) {
-    double time = 0.0;
-    size_t original_pos = tape.get_current_position();
     
-    // 从当前位置开始搜索
-    for (size_t i = 0; i < tape.get_block_count(); ++i) {
-        size_t pos = (original_pos + i) % tape.get_block_count();
-        time += tape.seek_to_block(pos);
-        
-        auto [block, read_time] = tape.read_current_block();
-        time += read_time;
-        
-        if (!block.is_index_block && block.block_id == data_id) {
-            return {pos, time};
-        }
+public:
+    TapeDevice(size_t block_size = 4096, 
+              double read_speed = 1024 * 1024,  // 1MB/s
+              double write_speed = 512 * 1024,   // 512KB/s
+              double seek_time = 0.01);          // 10ms per block
+    
+    // 写入块（追加到数据分区末尾，并通知追加写入观察者）
+    double write_block(const TapeBlock& block);
+    
+    // 注册/注销追加写入观察者；write_block与write_synthetic_block写入后依次通知，emplace_block不通知
+    void add_append_observer(BlockAppendObserver* observer) { append_observers.push_back(observer); }
+    void remove_append_observer(BlockAppendObserver* observer);
+    
+    // 原地写入块：在设备字节池中分配size字节，返回可写指针（下一次写入前有效）和写入耗时
+    std::pair<uint8_t*, double> emplace_block(uint64_t block_id, size_t size, bool is_index = false);
+    
+    // 写入合成数据块：只记录长度，不占用数据存储（需先切换到合成模式）
+    double write_synthetic_block(uint64_t block_id, size_t size);
+    
+    // 按预计块数和数据总量预留存储
+    void reserve(size_t block_count, size_t payload_bytes) { blocks.reserve(block_count, payload_bytes); }
+    
+    // 设置数据存放模式（需在磁带为空时调用）
+    void set_payload_mode(PayloadMode mode, uint64_t seed = 0x5EEDULL) { blocks.set_payload_mode(mode, seed); }
+    PayloadMode get_payload_mode() const { return blocks.payload_mode(); }
+    
+    // 获取指定块的数据（合成块按需生成），不产生模拟耗时
+    std::vector<uint8_t> load_payload(size_t index) const;
+    
+    // 读取当前块（返回副本）
+    std::pair<TapeBlock, double> read_current_block();
+    
+    // 读取当前块（零拷贝视图），模拟耗时与read_current_block一致
+    std::pair<TapeBlockView, double> view_current_block();
+    
+    // 静态分派的查询路径（供编译期特化的Simulator使用）：与seek_to_block/view_current_block结果一致，但不做边界检查
+    // 调用方须保证寻道模型与缓冲区的实际类型恰为Model与Cache（Cache为NoBlockCache时未设置缓冲区），
+    // 且block_index在数据分区内
+    template <typename Model, typename Cache>
+    double seek_to_block_unchecked(size_t block_index) { return seek_to_as<Model, Cache>(TapeRegion::Data, block_index); }
+    template <typename Model, typename Cache>
+    std::pair<TapeBlockView, double> view_current_block_unchecked() { return view_current_block_as<Model, Cache>(); }
+    
+    // 设置寻道模型（nullptr恢复为线性模型）
+    void set_seek_model(std::unique_ptr<SeekModel> model);
+    const SeekModel& get_seek_model() const { return *seek_model; }
+    
+    // 设置磁道几何
+    void set_geometry(const TapeGeometry& value) { geometry = value; }
+    const TapeGeometry& get_geometry() const { return geometry; }
+    
+    // 块的物理坐标（供调度器按物理位置安排访问顺序）
+    TapeCoordinate get_coordinate(size_t block_index) const { return coordinate_of(TapeRegion::Data, block_index); }
+    TapeCoordinate get_coordinate(const BlockAddress& address) const {
+        return coordinate_of(address.region, address.position);
     }
     
-    // 未找到
-    return {std::string::npos, time};
-}
-
-std::string NoIndexStrategy::get_name() const {
-    return "No Index";
-}
+    // 磁带实际位置的物理坐标（缓存命中时磁带不移动，可能与逻辑位置不同）
+    TapeCoordinate get_head_coordinate() const { return coordinate_of(head_region, head_position); }
+    
+    // 设置缓冲区：命中的块不产生寻道、按缓冲区带宽计费；未命中时从磁带读取并预读其后的块
+    // （预读的传输耗时计入触发它的读取），之后磁带停在最后预读的块上
+    void set_cache(const DeviceCacheConfig& config);
+    const DeviceCacheConfig& get_cache_config() const { return cache_config; }
+    const DeviceCacheStats& get_cache_stats() const { return cache_stats; }
+    const BlockCache* get_cache() const { return cache.get(); }
+    void reset_cache_stats() { cache_stats = DeviceCacheStats(); }
+    
+    // 热路径计数器（顺序扫描中的回绕计为一次重新定位）
+    const DeviceIoStats& get_io_stats() const { return io_stats; }
+    void reset_io_stats() {
+        io_stats = DeviceIoStats();
+        motion_direction = 0;
+    }
+    
+    // 移动到数据分区的指定块
+    double seek_to_block(size_t block_index);
+    
+    // 移动到指定区域的指定块
+    double seek_to(TapeRegion region, size_t position);
+    double seek_to(const BlockAddress& address) { return seek_to(address.region, address.position); }
+    
+    // 在当前区域内向前移动n个块
+    double move_forward(size_t n = 1);
+    
+    // 在当前区域内向后移动n个块
+    double move_backward(size_t n = 1);
+    
+    // 从当前位置起顺序读取数据分区的count个块（到末尾后回绕到0），停在最后读取的块上
+    // 磁头不在数据分区时先移动到get_data_position()；经过的穿插块计入寻道距离
+    // 顺序扫描直接从磁带流式读取，不经过缓冲区
+    // 耗时按闭式计算，相邻数据块间隔不超过寻道模型的stream_window时与逐块seek_to_block + view_current_block的总和一致
+    double scan_blocks(size_t count);
+    
+    // 获取当前位置（当前区域内）
+    size_t get_current_position() const;
+    
+    // 获取磁头所在区域
+    TapeRegion get_current_region() const { return current_region; }
+    
+    // 磁头在数据分区上的对应位置：索引分区对应0，穿插块对应其后的数据块
+    size_t get_data_position() const;
+    
+    // 获取数据分区块数量
+    size_t get_block_count() const;
+    
+    // 获取指定区域的块数量
+    size_t get_block_count(TapeRegion region) const { return region_store(region).size(); }
+    
+    // 格式化磁带开头的索引分区（capacity块，0表示取消分区），清空全部索引分区块和穿插块
+    void format_index_partition(size_t capacity);
+    size_t get_index_partition_capacity() const { return index_partition_capacity; }
+    
+    // 写入索引分区，返回(分区内位置, 写入耗时)；分区已满时抛出std::length_error
+    std::pair<size_t, double> write_index_partition_block(const TapeBlock& block);
+    
+    // 在数据块anchor之后写入穿插块，返回(穿插块序号, 写入耗时)；锚点须按非降序写入
+    std::pair<size_t, double> write_interleaved_block(size_t anchor, const TapeBlock& block);
+    
+    // 清空索引分区块和穿插块（保留分区容量）
+    void clear_index_blocks();
+    
+    // 获取指定位置的块（返回副本）
+    TapeBlock get_block(size_t index) const;
+    
+    // 获取指定位置的块视图（不产生模拟耗时）
+    TapeBlockView view_block(size_t index) const;
+    
+    // 获取底层列式存储（默认数据分区）
+    const TapeBlockStore& get_store(TapeRegion region = TapeRegion::Data) const { return region_store(region); }
+    
+    // 重置磁带
+    void reset();
+    
+    // 保存磁带镜像（块大小、元数据表和数据区；不含索引分区块和穿插块）
+    void save_image(const std::string& path) const;
+    
+    // 通过mmap打开磁带镜像（不复制数据），之后写入的块追加在镜像之后的内存中
+    void open_image(const std::string& path);
+    
+    // 创建独立游标：参数相同、共享本设备块数据（只读，不复制）的新设备，位置从0开始
+    // 新设备写入的块只追加到其自身存储中；在游标使用期间本设备的块不得修改
+    // 游标沿用索引分区容量，但不含本设备的索引分区块和穿插块
+    TapeDevice create_cursor() const;
+    
+    // 获取块大小
+    size_t get_block_size() const { return block_size; }
+};
 
-std::string NoIndexStrategy::get_stats() const {
-    return "No index used";
-}
+// 索引容器接口：uint64键到uint64值的查找结构，先build后查询
+class IndexContainer {
+public:
+    virtual ~IndexContainer() = default;
+    
+    // 由(键, 值)序列构建，重复键保留最后一次出现的值
+    virtual void build(std::vector<std::pair<uint64_t, uint64_t>> entries) = 0;
+    
+    // 插入或覆盖单个条目（追加写入时的增量维护）
+    virtual void insert(uint64_t key, uint64_t value) = 0;
+    
+    // 查找键，找到时写入value并返回true
+    virtual bool find(uint64_t key, uint64_t& value) const = 0;
+    
+    // 条目数
+    virtual size_t size() const = 0;
+    
+    // 占用的主机内存（字节）
+    virtual size_t memory_bytes() const = 0;
+    
+    // 容器名称
+    virtual std::string get_name() const = 0;
+};
 
-// FixedIntervalIndexStrategy 实现
-FixedIntervalIndexStrategy::FixedIntervalIndexStrategy(size_t interval) : interval(interval) {}
+// 哈希表容器（std::unordered_map）
+class HashIndexContainer final : public IndexContainer {
+private:
+    std::unordered_map<uint64_t, uint64_t> entries_map;
+    
+public:
+    void build(std::vector<std::pair<uint64_t, uint64_t>> entries) override;
+    void insert(uint64_t key, uint64_t value) override { entries_map[key] = value; }
+    bool find(uint64_t key, uint64_t& value) const override;
+    size_t size() const override { return entries_map.size(); }
+    size_t memory_bytes() const override;
+    std::string get_name() const override { return "hash"; }
+};
 
-double FixedIntervalIndexStrategy::build_index(TapeDevice& tape) {
-    index_map.clear();
-    double time = 0.0;
-    size_t original_pos = tape.get_current_position();
+// 静态布局容器基类：新插入的条目先放在增量哈希表中，查找时优先查增量表
+// 增量表超过静态部分的1/8（至少64条）时与静态部分合并重建；合并需排序增量表，插入均摊O(log n)
+class StaticLayoutIndexContainer : public IndexContainer {
+private:
+    std::unordered_map<uint64_t, uint64_t> delta;  // 尚未合并的条目（可覆盖静态部分）
+    size_t delta_new_keys = 0;                     // 增量表中静态部分没有的键数
     
-    // 回到起始位置
-    time += tape.seek_to_block(0);
+    void merge();
     
-    // 创建索引
-    for (size_t i = 0; i < tape.get_block_count(); ++i) {
-        // 读取当前块
-        auto [block, read_time] = tape.read_current_block();
-        time += read_time;
-        
-        // 如果是数据块，添加到索引
-        if (!block.is_index_block) {
-            index_map[block.block_id] = i;
-            
-            // 每隔interval个数据块创建一个索引块
-            if (index_map.size() % interval == 0) {
-                std::vector<uint8_t> index_data;
-                TapeBlock index_block(block.block_id + 1000000, index_data, true);
-                time += tape.write_block(index_block);
-                time += tape.move_forward(1);
+protected:
+    // 是否有尚未合并的插入
+    bool has_pending_inserts() const { return !delta.empty(); }
+    
+    // 由有序去重后的条目构建静态布局
+    virtual void build_static(const std::vector<std::pair<uint64_t, uint64_t>>& sorted) = 0;
+    
+    // 在静态布局中查找
+    virtual bool find_static(uint64_t key, uint64_t& value) const = 0;
+    
+    // 按键升序导出静态布局中的条目
+    virtual void export_static(std::vector<std::pair<uint64_t, uint64_t>>& out) const = 0;
+    
+    // 静态布局中的条目数与内存
+    virtual size_t static_size() const = 0;
+    virtual size_t static_memory_bytes() const = 0;
+    
+public:
+    void build(std::vector<std::pair<uint64_t, uint64_t>> entries) override;
+    void insert(uint64_t key, uint64_t value) override;
+    bool find(uint64_t key, uint64_t& value) const override;
+    size_t size() const override { return static_size() + delta_new_keys; }
+    size_t memory_bytes() const override;
+    
+    // 静态分派的查找：Layout为实际的派生类型，直接调用其find_static（可内联）
+    template <typename Layout>
+    bool find_as(uint64_t key, uint64_t& value) const {
+        if (!delta.empty()) {
+            auto it = delta.find(key);
+            if (it != delta.end()) {
+                value = it->second;
+                return true;
             }
         }
-        
-        // 移动到下一个块
-        if (i < tape.get_block_count() - 1) {
-            time += tape.move_forward(1);
+        if constexpr (std::is_same_v<Layout, StaticLayoutIndexContainer>) {
+            return find_static(key, value);
+        } else {
+            return static_cast<const Layout&>(*this).Layout::find_static(key, value);
         }
     }
+};
+
+// 有序平坦数组容器：键值分列存放，无分支二分查找
+// 没有待合并的插入且键递增时直接追加（均摊O(1)），乱序插入进入增量表按批归并，不再逐个移动数组元素
+class SortedArrayIndexContainer final : public StaticLayoutIndexContainer {
+private:
+    friend class StaticLayoutIndexContainer;
     
-    // 回到原始位置
-    time += tape.seek_to_block(original_pos);
+    std::vector<uint64_t> keys;
+    std::vector<uint64_t> values;
     
-    return time;
-}
-
-std::pair<size_t, double> FixedIntervalIndexStrategy::find_block(TapeDevice& tape, uint64_t data_id) {
-    double time = 0.0;
-    // 修复警告：移除未使用的变量original_pos
-    // size_t original_pos = tape.get_current_position();
+protected:
+    void build_static(const std::vector<std::pair<uint64_t, uint64_t>>& sorted) override;
+    bool find_static(uint64_t key, uint64_t& value) const override;
+    void export_static(std::vector<std::pair<uint64_t, uint64_t>>& out) const override;
+    size_t static_size() const override { return keys.size(); }
+    size_t static_memory_bytes() const override;
     
-    auto it = index_map.find(data_id);
-    if (it == index_map.end()) {
-        return {std::string::npos, 0.0};
-    }
+public:
+    void insert(uint64_t key, uint64_t value) override;
+    std::string get_name() const override { return "sorted"; }
+};
+
+// Eytzinger布局容器：按隐式完全二叉树的层序存放，查找时预取后续层
+class EytzingerIndexContainer final : public StaticLayoutIndexContainer {
+private:
+    friend class StaticLayoutIndexContainer;
     
-    size_t target_pos = it->second;
-    time += tape.seek_to_block(target_pos);
+    std::vector<uint64_t> keys;    // keys[0]不使用，节点k的子节点为2k和2k+1
+    std::vector<uint64_t> values;
     
-    auto [block, read_time] = tape.read_current_block();
-    time += read_time;
+    size_t fill(const std::vector<std::pair<uint64_t, uint64_t>>& sorted, size_t next, size_t k);
+    void collect(std::vector<std::pair<uint64_t, uint64_t>>& out, size_t k) const;
     
-    if (block.block_id != data_id) {
-        return {std::string::npos, time};
-    }
+protected:
+    void build_static(const std::vector<std::pair<uint64_t, uint64_t>>& sorted) override;
+    bool find_static(uint64_t key, uint64_t& value) const override;
+    void export_static(std::vector<std::pair<uint64_t, uint64_t>>& out) const override { collect(out, 1); }
+    size_t static_size() const override { return keys.empty() ? 0 : keys.size() - 1; }
+    size_t static_memory_bytes() const override;
     
-    return {target_pos, time};
-}
-
-std::string FixedIntervalIndexStrategy::get_name() const {
-    return "Fixed Interval Index";
-}
+public:
+    std::string get_name() const override { return "eytzinger"; }
+};
 
-std::string FixedIntervalIndexStrategy::get_stats() const {
-    std::stringstream ss;
-    ss << "Interval: " << interval << ", Index entries: " << index_map.size();
-    return ss.str();
-}
+// 静态B树容器：每个节点8个键（一条64字节缓存行），节点k的第i个子节点为k*9+i+1
+// 键UINT64_MAX保留作填充
+class BTreeIndexContainer final : public StaticLayoutIndexContainer {
+public:
+    static const size_t NODE_KEYS = 8;
+    
+private:
+    friend class StaticLayoutIndexContainer;
+    
+    std::vector<uint64_t> keys;    // 节点键，按节点连续存放
+    std::vector<uint64_t> values;  // 与keys一一对应
+    size_t node_count = 0;
+    size_t entry_count = 0;
+    
+    size_t fill(const std::vector<std::pair<uint64_t, uint64_t>>& sorted, size_t next, size_t node);
+    void collect(std::vector<std::pair<uint64_t, uint64_t>>& out, size_t node) const;
+    
+protected:
+    void build_static(const std::vector<std::pair<uint64_t, uint64_t>>& sorted) override;
+    bool find_static(uint64_t key, uint64_t& value) const override;
+    void export_static(std::vector<std::pair<uint64_t, uint64_t>>& out) const override { collect(out, 0); }
+    size_t static_size() const override { return entry_count; }
+    size_t static_memory_bytes() const override;
+    
+public:
+    std::string get_name() const override { return "btree"; }
+};
 
-// HierarchicalIndexStrategy 实现
-HierarchicalIndexStrategy::HierarchicalIndexStrategy(size_t level1, size_t level2)
-    : level1_interval(level1), level2_interval(level2) {}
+// 设备未设置缓冲区时静态分派使用的缓存类型
+struct NoBlockCache {};
 
-double HierarchicalIndexStrategy::build_index(TapeDevice& tape) {
-    index_map.clear();
-    double time = 0.0;
-    size_t original_pos = tape.get_current_position();
-    size_t block_count = tape.get_block_count();
+// 按静态类型调用块缓存（规则同SeekModelOps）
+template <typename Cache>
+struct BlockCacheOps {
+    static bool lookup(BlockCache& cache, uint64_t key) {
+        if constexpr (std::is_same_v<Cache, BlockCache>) {
+            return cache.lookup(key);
+        } else {
+            return static_cast<Cache&>(cache).Cache::lookup(key);
+        }
+    }
     
-    time += tape.seek_to_block(0);
+    static bool contains(const BlockCache& cache, uint64_t key) {
+        if constexpr (std::is_same_v<Cache, BlockCache>) {
+            return cache.contains(key);
+        } else {
+            return static_cast<const Cache&>(cache).Cache::contains(key);
+        }
+    }
     
-    std::vector<std::pair<uint64_t, size_t>> data_blocks;
-    for (size_t i = 0; i < block_count; ++i) {
-        auto [block, read_time] = tape.read_current_block();
-        time += read_time;
-        
-        if (!block.is_index_block) {
-            data_blocks.emplace_back(block.block_id, i);
+    static void insert(BlockCache& cache, uint64_t key, size_t bytes) {
+        if constexpr (std::is_same_v<Cache, BlockCache>) {
+            cache.insert(key, bytes);
+        } else {
+            static_cast<Cache&>(cache).Cache::insert(key, bytes);
         }
-        
-        if (i < block_count - 1) {
-            time += tape.move_forward(1);
+    }
+};
+
+// 按静态类型调用索引容器的查找（规则同SeekModelOps）；静态布局容器直接调用派生类的find_static
+template <typename Container>
+struct IndexContainerOps {
+    static bool find(const IndexContainer& container, uint64_t key, uint64_t& value) {
+        if constexpr (std::is_same_v<Container, IndexContainer>) {
+            return container.find(key, value);
+        } else if constexpr (std::is_base_of_v<StaticLayoutIndexContainer, Container>) {
+            return static_cast<const Container&>(container).template find_as<Container>(key, value);
+        } else {
+            return static_cast<const Container&>(container).Container::find(key, value);
         }
     }
+};
+
+// 索引容器工厂：type取 "hash" / "sorted" / "eytzinger" / "btree"
+class IndexContainerFactory {
+public:
+    static std::unique_ptr<IndexContainer> create_container(const std::string& type);
+};
+
+// 成员过滤器：判断键是否可能在磁带上，否定回答一定正确，肯定回答有一定误判率
+class MembershipFilter {
+public:
+    virtual ~MembershipFilter() = default;
     
-    std::vector<uint8_t> level2_data;
-    TapeBlock level2_block(1000000, level2_data, true);
-    time += tape.write_block(level2_block);
+    // 由全部键构建，按bits_per_key确定大小
+    virtual void build(const std::vector<uint64_t>& keys) = 0;
     
-    std::vector<uint8_t> level1_data;
-    TapeBlock level1_block(2000000, level1_data, true);
-    time += tape.write_block(level1_block);
+    // 插入单个键（追加写入时的增量维护）
+    virtual void insert(uint64_t key) = 0;
     
-    for (size_t i = 0; i < data_blocks.size(); ++i) {
-        auto [id, pos] = data_blocks[i];
-        size_t level2_idx = i / level2_interval;
-        size_t level1_idx = level2_idx / level1_interval;
-        index_map[id] = {level1_idx, level2_idx};
-    }
+    // 键可能存在时返回true
+    virtual bool may_contain(uint64_t key) const = 0;
     
-    time += tape.seek_to_block(original_pos);
+    // 按当前键数估算的误判率
+    virtual double expected_false_positive_rate() const = 0;
     
-    return time;
-}
+    // 占用的主机内存（字节）
+    virtual size_t memory_bytes() const = 0;
+    
+    // 过滤器名称
+    virtual std::string get_name() const = 0;
+};
 
-std::pair<size_t, double> HierarchicalIndexStrategy::find_block(TapeDevice& tape, uint64_t data_id) {
-    double time = 0.0;
-    // 修复警告：移除未使用的变量original_pos
-    // size_t original_pos = tape.get_current_position();
+// 标准Bloom过滤器：m = n * bits_per_key位，k个哈希位由双重哈希生成
+// 追加写入使键数超过当前容量时，另起一层容量翻倍的过滤器（可扩展Bloom），旧层只读，查询依次检查各层
+class BloomFilter : public MembershipFilter {
+private:
+    struct Layer {
+        std::vector<uint64_t> bits;
+        size_t bit_count = 0;
+        size_t capacity = 0;   // 按bits_per_key可容纳的键数
+        size_t key_count = 0;
+    };
     
-    auto it = index_map.find(data_id);
-    if (it == index_map.end()) {
-        return {std::string::npos, 0.0};
-    }
+    size_t bits_per_key;
+    size_t hash_count = 1;
+    std::vector<Layer> layers;
+    size_t key_count = 0;
     
-    auto [level1_idx, level2_idx] = it->second;
+    void add_layer(size_t capacity);
     
-    size_t level1_pos = tape.get_block_count() - 2;
-    time += tape.seek_to_block(level1_pos);
-    time += tape.read_current_block().second;
+public:
+    explicit BloomFilter(size_t bits_per_key = 10);
+    void build(const std::vector<uint64_t>& keys) override;
+    void insert(uint64_t key) override;
+    bool may_contain(uint64_t key) const override;
+    double expected_false_positive_rate() const override;
+    size_t memory_bytes() const override;
+    std::string get_name() const override { return "bloom"; }
+};
+
+// 分块Bloom过滤器：每个键的k个位都落在同一个512位（一条缓存行）的块内，查询只访问一条缓存行
+// 与标准Bloom过滤器相同，键数超过容量时另起一层容量翻倍的过滤器
+class BlockedBloomFilter : public MembershipFilter {
+public:
+    static const size_t BLOCK_WORDS = 8;  // 每块8个u64
     
-    size_t level2_pos = tape.get_block_count() - 1;
-    time += tape.seek_to_block(level2_pos);
-    time += tape.read_current_block().second;
+private:
+    struct Layer {
+        std::vector<uint64_t> blocks;  // block_count * BLOCK_WORDS
+        size_t block_count = 0;
+        size_t capacity = 0;
+        size_t key_count = 0;
+    };
     
-    size_t target_pos = (level1_idx * level1_interval + level2_idx) * level2_interval;
-    if (target_pos >= tape.get_block_count() - 2) {
-        target_pos = tape.get_block_count() - 3;
-    }
+    size_t bits_per_key;
+    size_t hash_count = 1;
+    std::vector<Layer> layers;
+    size_t key_count = 0;
     
-    time += tape.seek_to_block(target_pos);
+    void add_layer(size_t capacity);
     
-    auto [block, read_time] = tape.read_current_block();
-    time += read_time;
+public:
+    explicit BlockedBloomFilter(size_t bits_per_key = 10);
+    void build(const std::vector<uint64_t>& keys) override;
+    void insert(uint64_t key) override;
+    bool may_contain(uint64_t key) const override;
+    double expected_false_positive_rate() const override;
+    size_t memory_bytes() const override;
+    std::string get_name() const override { return "blocked-bloom"; }
+};
+
+// 商过滤器：指纹拆成q位商和r位余数，余数按商线性探测存放，每槽附带occupied/continuation/shifted三个标志位
+// 装载率超过90%时把商扩大一位（余数相应减少一位）并重建，余数只剩1位时抛出std::length_error
+class QuotientFilter : public MembershipFilter {
+private:
+    size_t bits_per_key;
+    size_t quotient_bits = 0;
+    size_t remainder_bits = 0;
+    size_t slot_count = 0;
+    std::vector<uint64_t> slots;  // 每槽remainder_bits + 3位紧凑存放：低3位为标志，其上为余数
+    size_t key_count = 0;
     
-    if (block.block_id != data_id) {
-        return {std::string::npos, time};
-    }
+    static const uint64_t OCCUPIED = 1;
+    static const uint64_t CONTINUATION = 2;
+    static const uint64_t SHIFTED = 4;
     
-    return {target_pos, time};
-}
+    uint64_t get_slot(size_t slot) const;
+    void set_slot(size_t slot, uint64_t value);
+    uint64_t flags(size_t slot) const { return get_slot(slot) & 7; }
+    uint64_t remainder(size_t slot) const { return get_slot(slot) >> 3; }
+    size_t next(size_t slot) const { return (slot + 1) & (slot_count - 1); }
+    size_t prev(size_t slot) const { return (slot + slot_count - 1) & (slot_count - 1); }
+    bool slot_empty(size_t slot) const { return flags(slot) == 0; }
+    
+    // 按商、余数位数分配空表
+    void allocate(size_t q, size_t r);
+    
+    // 找到商fq所在的游程起点（fq必须已标记occupied）
+    size_t run_start(size_t fq) const;
+    
+    void insert_fingerprint(uint64_t fq, uint64_t fr);
+    
+    // 装载率过高时扩容：遍历所有指纹，按q+1位商重建
+    void grow();
+    
+public:
+    explicit QuotientFilter(size_t bits_per_key = 10);
+    void build(const std::vector<uint64_t>& keys) override;
+    void insert(uint64_t key) override;
+    bool may_contain(uint64_t key) const override;
+    double expected_false_positive_rate() const override;
+    size_t memory_bytes() const override { return slots.capacity() * sizeof(uint64_t); }
+    std::string get_name() const override { return "quotient"; }
+};
 
-std::string HierarchicalIndexStrategy::get_name() const {
-    return "Hierarchical Index";
-}
+// 过滤器工厂：type取 "bloom" / "blocked-bloom" / "quotient"，"none"返回nullptr
+class MembershipFilterFactory {
+public:
+    static std::unique_ptr<MembershipFilter> create_filter(const std::string& type, size_t bits_per_key = 10);
+};
 
-std::string HierarchicalIndexStrategy::get_stats() const {
-    std::stringstream ss;
-    ss << "Level1 interval: " << level1_interval 
-       << ", Level2 interval: " << level2_interval
-       << ", Index entries: " << index_map.size();
-    return ss.str();
-}
+// 批量查询的物理访问调度方式
+enum class BatchSchedule {
+    FIFO,   // 按到达顺序
+    SCAN,   // 电梯算法：先向磁带末端扫描，到达末端后反向
+    CSCAN,  // 循环扫描：到达末端后回卷到起点，始终正向访问
+    LOOK,   // 与SCAN相同，但在最远的请求处直接反向
+    WRAP_LOOK,  // 按物理坐标沿纵向往返：每一趟只访问方向与该趟一致的磁道上的请求
+    RAO         // 推荐访问顺序：按寻道模型求近似最短路径（限时）
+};
 
-// IndexStrategyFactory 实现
-std::unique_ptr<IndexStrategy> IndexStrategyFactory::create_strategy(const std::string& type, 
-                                                                    size_t param1, 
-                                                                    size_t param2) {
-    if (type == "none") {
-        return std::make_unique<NoIndexStrategy>();
-    } else if (type == "fixed") {
-        return std::make_unique<FixedIntervalIndexStrategy>(param1 > 0 ? param1 : 10);
-    } else if (type == "hierarchical") {
-        return std::make_unique<HierarchicalIndexStrategy>(
-            param1 > 0 ? param1 : 100, 
-            param2 > 0 ? param2 : 10
-        );
-    } else {
-        throw std::invalid_argument("Unknown index strategy: " + type);
+// 调度方式名称与解析
+const char* batch_schedule_name(BatchSchedule schedule);
+BatchSchedule parse_batch_schedule(const std::string& name);
+
+// 调度后的一次访问：request为请求下标，npos表示仅为换向/回卷而寻道
+struct BatchStop {
+    size_t position;
+    size_t request;
+};
+
+// 从磁头位置head出发，为已解析的块位置安排访问顺序（positions中npos的请求被跳过）
+// 只按逻辑位置排序；WRAP_LOOK在此按LOOK处理
+std::vector<BatchStop> schedule_batch(const std::vector<size_t>& positions, size_t head,
+                                      size_t block_count, BatchSchedule schedule);
+
+// 批量调度统计；RAO求解时间上限也经由此传入
+struct BatchStats {
+    double rao_time_budget_ms = 2.0;  // RAO每批求解时间上限（主机毫秒）
+    size_t batches = 0;               // 已调度的批次数
+    double schedule_cpu_ms = 0.0;     // 调度消耗的主机CPU时间（毫秒）
+};
+
+// 从磁带当前磁头出发安排访问顺序：WRAP_LOOK查询各块的物理坐标，RAO使用设备的寻道模型
+// 其余调度方式按逻辑位置处理；stats非空时累计调度统计
+std::vector<BatchStop> schedule_batch(const std::vector<size_t>& positions, const TapeDevice& tape,
+                                      BatchSchedule schedule, BatchStats* stats = nullptr);
+
+// 推荐访问顺序（RAO）求解器：以磁头为起点的开放路径TSP
+// 先取最近邻贪心、LOOK、WRAP-LOOK中估算耗时最短者作为初始解，再交替做2-opt和Or-opt改进，
+// 直到无改进或超出时间上限
+class RaoOptimizer {
+private:
+    double time_budget_ms;
+    
+public:
+    explicit RaoOptimizer(double time_budget_ms = 2.0) : time_budget_ms(time_budget_ms) {}
+    
+    std::vector<BatchStop> optimize(const std::vector<size_t>& positions, const TapeDevice& tape) const;
+    
+    // 按设备寻道模型估算从磁头出发依次访问stops的寻道耗时（模拟秒）
+    static double estimate_seek_time(const std::vector<BatchStop>& stops, const TapeDevice& tape);
+};
+
+// 紧凑索引页格式：按块ID排序的(块ID, 位置)条目，ID差值与位置差值（zigzag）以LEB128变长整数编码
+// 页头为4字节魔数与4字节条目数；每页从0开始差分，可单独解码
+class IndexPageCodec {
+public:
+    using Entry = std::pair<uint64_t, uint64_t>;
+    
+    static constexpr uint32_t MAGIC = 0x58495446;       // "FTIX"
+    static constexpr size_t HEADER_BYTES = 8;
+    static constexpr size_t MAX_ENTRY_BYTES = 20;       // 两个变长整数的最大长度
+    static constexpr size_t RAW_ENTRY_BYTES = 16;       // 未压缩布局每个条目的字节数
+    
+    // 写入value的变长编码，返回字节数（1到10）
+    static size_t put_varint(uint64_t value, uint8_t* out);
+    
+    // 读取一个变长整数，返回其后的位置；数据截断或超过10字节时抛出std::runtime_error
+    static const uint8_t* get_varint(const uint8_t* in, const uint8_t* end, uint64_t& value);
+    
+    // 把entries按(块ID, 位置)排序后切分为不超过page_size字节的页
+    static std::vector<std::vector<uint8_t>> encode(std::vector<Entry> entries, size_t page_size);
+    
+    // 解码一页，条目按页内顺序追加到out；格式错误或count个条目之后还有多余字节时抛出std::runtime_error
+    static void decode(const uint8_t* data, size_t size, std::vector<Entry>& out);
+};
+
+// 索引块放置方式
+enum class IndexPlacement {
+    End,          // 追加在数据分区末尾
+    Interleaved,  // 穿插在所描述的数据块之后
+    Partition     // 写入磁带开头的索引分区（LTFS方式）
+};
+
+// 放置方式名称与解析
+const char* index_placement_name(IndexPlacement placement);
+IndexPlacement parse_index_placement(const std::string& name);
+
+// 索引块缓存策略：决定查询时读过的索引块是否保留在主机内存中
+enum class IndexCachePolicy {
+    None,     // 不缓存，每次查询都从磁带读取
+    PinTop,   // 常驻顶层块（分层索引的一级块、B+树根节点）
+    PinAll,   // 常驻所有读过的索引块；索引分区在第一次访问时整体顺序读入
+    Lru       // 按LRU保留最近使用的N个索引块
+};
+
+// 索引缓存策略名称与解析
+const char* index_cache_policy_name(IndexCachePolicy policy);
+IndexCachePolicy parse_index_cache_policy(const std::string& name);
+
+// 成员过滤器统计：rejected为被过滤器直接否定的查询，false_positives为通过过滤器但磁带上不存在的查询
+struct FilterStats {
+    std::string name = "none";
+    size_t memory_bytes = 0;
+    double expected_fpp = 0.0;
+    size_t rejected = 0;
+    size_t passed = 0;
+    size_t false_positives = 0;
+    
+    // 实测误判率：不存在的键中通过过滤器的比例
+    double observed_fpp() const {
+        size_t negatives = rejected + false_positives;
+        return negatives > 0 ? static_cast<double>(false_positives) / negatives : 0.0;
+    }
+};
+
+// 索引策略基类
+// 作为追加写入观察者注册到TapeDevice后，每写入一个块调用on_append增量维护索引，无需重新扫描整盘磁带
+class IndexStrategy : public BlockAppendObserver {
+public:
+    virtual ~IndexStrategy() = default;
+    
+    // 设置索引块放置方式（在build_index之前调用）
+    void set_index_placement(IndexPlacement value) { placement = value; }
+    IndexPlacement get_index_placement() const { return placement; }
+    
+    // 设置索引块缓存策略，lru_blocks为LRU策略保留的块数；会清空已缓存的块
+    void set_index_cache(IndexCachePolicy policy, size_t lru_blocks = 0);
+    IndexCachePolicy get_index_cache_policy() const { return cache_policy; }
+    
+    // 设置构建索引时主机端收集块信息的线程数（0或1为逐块串行扫描）
+    // 多线程时各线程处理一段连续的块区间，模拟耗时仍按一次顺序扫描计算
+    void set_build_threads(size_t threads) { build_threads = threads; }
+    
+    // 索引块缓存占用的主机内存（字节）
+    size_t index_cache_bytes() const { return cache_bytes; }
+    
+    // 每盘磁带常驻主机内存的索引字节数（内存容器与索引块缓存之和）
+    virtual size_t memory_bytes() const { return cache_bytes; }
+    
+    // 累计写到磁带上的索引块数与数据字节数
+    virtual size_t index_blocks_written() const { return tape_index_blocks; }
+    virtual size_t index_bytes_written() const { return tape_index_bytes; }
+    
+    // 成员过滤器统计（未使用过滤器时name为"none"）
+    virtual FilterStats get_filter_stats() const { return {}; }
+    
+    // 构建索引
+    virtual double build_index(TapeDevice& tape) = 0;
+    
+    // 查找数据块
+    virtual std::pair<size_t, double> find_block(TapeDevice& tape, uint64_t data_id) = 0;
+    
+    // 是否支持追加写入时的增量维护
+    virtual bool supports_append() const { return false; }
+    
+    // 增量维护：把新写入的块加入索引，返回写入索引块的耗时；索引块本身被忽略
+    // 不支持增量维护的策略抛出std::logic_error，需在写入后重新build_index
+    double on_append(TapeDevice& tape, const TapeBlockView& block, size_t position) override;
+    
+    // 是否能在读取数据块之前通过索引解析出块位置
+    virtual bool supports_position_lookup() const { return false; }
+    
+    // 批量解析块位置（可能读取索引块），positions/times与data_ids一一对应，无法定位时为npos
+    virtual void resolve_positions(TapeDevice& tape, const std::vector<uint64_t>& data_ids,
+                                   std::vector<size_t>& positions, std::vector<double>& times);
+    
+    // 批量查找：先解析位置，再按调度方式重排物理访问，结果与data_ids一一对应
+    // 不支持位置解析的策略按到达顺序逐个调用find_block
+    // stats非空时累计调度统计（用于报告RAO等调度的主机耗时）
+    virtual std::vector<std::pair<size_t, double>> find_blocks(TapeDevice& tape,
+                                                               const std::vector<uint64_t>& data_ids,
+                                                               BatchSchedule schedule = BatchSchedule::LOOK,
+                                                               BatchStats* stats = nullptr);
+    
+    // 获取策略名称
+    virtual std::string get_name() const = 0;
+    
+    // 获取索引统计信息
+    virtual std::string get_stats() const = 0;
+    
+protected:
+    IndexPlacement placement = IndexPlacement::End;
+    
+    // 缓存的索引块：数据在主机内存中的副本
+    struct CachedIndexBlock {
+        uint64_t block_id;
+        std::vector<uint8_t> data;
+        bool pinned;                            // 常驻块不参与LRU淘汰
+        std::list<uint64_t>::iterator lru_pos;  // 在LRU链表中的位置（仅非常驻块有效）
+    };
+    
+    IndexCachePolicy cache_policy = IndexCachePolicy::None;
+    size_t cache_capacity_blocks = 0;                         // LRU策略的块数上限
+    std::unordered_map<uint64_t, CachedIndexBlock> index_cache;  // 键为编码后的块地址
+    std::list<uint64_t> cache_lru;                            // 非常驻块，表头为最近使用
+    size_t cache_bytes = 0;                                   // 缓存数据字节数
+    size_t cache_peak_bytes = 0;                              // 缓存数据峰值字节数
+    size_t cache_hits = 0;
+    size_t cache_misses = 0;
+    bool partition_loaded = false;  // 索引分区是否已整体读入缓存（写入索引块后失效）
+    size_t tape_index_blocks = 0;   // place_index_block写入的块数
+    size_t tape_index_bytes = 0;    // place_index_block写入的数据字节数
+    size_t build_threads = 1;       // 构建索引的主机线程数
+    
+    // 按连续区间并行收集前block_count个块中数据块的(块ID, 位置)，结果按位置升序
+    static void collect_data_blocks(const TapeBlockStore& store, size_t block_count, size_t threads,
+                                    std::vector<std::pair<uint64_t, size_t>>& out);
+    
+    // 并行构建时的扫描：从块0起一次顺序读完block_count个块（闭式计算耗时），并收集数据块
+    double scan_data_blocks(TapeDevice& tape, size_t block_count, std::vector<std::pair<uint64_t, size_t>>& out);
+    
+    // 解析单个块位置（默认不支持）
+    virtual std::pair<size_t, double> resolve_position(TapeDevice& tape, uint64_t data_id);
+    
+    // 定位并读取块，校验块ID，返回(位置或npos, 耗时)
+    std::pair<size_t, double> read_and_verify(TapeDevice& tape, size_t position, uint64_t data_id);
+    
+    // 按放置方式写入索引块（不移动磁头），anchor为穿插放置时紧邻其前的数据块位置
+    // 已缓存的索引块不受影响；build_index重新构建时由各策略清空缓存
+    std::pair<BlockAddress, double> place_index_block(TapeDevice& tape, const TapeBlock& block, size_t anchor);
+    
+    // 定位并读取索引块，按缓存策略命中时不产生I/O；top_level标记该块是否属于索引顶层
+    // PinAll策略下索引分区在第一次读取时整体顺序读入并缓存
+    std::pair<TapeBlockView, double> read_index_block(TapeDevice& tape, const BlockAddress& address,
+                                                      bool top_level = false);
+    
+    // 清空索引块缓存（重新构建索引或更换缓存策略时调用）
+    void clear_index_cache();
+    
+    // 索引缓存统计信息，供get_stats拼接
+    std::string index_cache_stats() const;
+    
+private:
+    // 把当前磁头处的块复制进缓存，返回缓存项
+    const CachedIndexBlock& cache_index_block(TapeDevice& tape, uint64_t key, bool pinned);
+};
+
+// 无索引策略
+class NoIndexStrategy final : public IndexStrategy {
+public:
+    // 修复警告：使用[[maybe_unused]]标记未使用参数
+    double build_index([[maybe_unused]] TapeDevice& tape) override;
+    std::pair<size_t, double> find_block(TapeDevice& tape, uint64_t data_id) override;
+    std::string get_name() const override;
+    std::string get_stats() const override;
+};
+
+// 磁带上紧凑索引页的统计
+struct IndexPageStats {
+    size_t pages = 0;          // 已写入的索引页数
+    size_t entries = 0;        // 页中的条目数
+    size_t bytes = 0;          // 页数据总字节数
+    double decode_ns = 0.0;    // 最近一次load_index解码页的主机耗时（纳秒）
+};
+
+// 固定间隔索引策略
+// 每interval个数据块的(块ID, 位置)以IndexPageCodec编码写成索引页，磁带可仅凭索引页重建内存容器
+class FixedIntervalIndexStrategy final : public IndexStrategy {
+private:
+    size_t interval;  // 索引间隔
+    std::unique_ptr<IndexContainer> index_map;  // 数据ID到块位置的映射
+    std::vector<IndexPageCodec::Entry> open_entries;  // 尚未写入索引页的条目
+    std::vector<BlockAddress> index_pages;            // 已写入索引页的地址（按写入顺序）
+    IndexPageStats page_stats;
+    
+    // 记录一个数据块，每interval个数据块写入一组索引页（写入不移动磁头）
+    double add_data_block(TapeDevice& tape, uint64_t block_id, size_t position);
+    
+    // 把open_entries编码写出，anchor为穿插放置时的锚点
+    double write_open_entries(TapeDevice& tape, size_t anchor);
+    
+public:
+    FixedIntervalIndexStrategy(size_t interval = 10, const std::string& container = "hash");
+    
+    double build_index(TapeDevice& tape) override;
+    std::pair<size_t, double> find_block(TapeDevice& tape, uint64_t data_id) override;
+    bool supports_append() const override { return true; }
+    double on_append(TapeDevice& tape, const TapeBlockView& block, size_t position) override;
+    bool supports_position_lookup() const override { return true; }
+    std::string get_name() const override;
+    std::string get_stats() const override;
+    size_t memory_bytes() const override;
+    
+    // 静态分派的查找（供Simulator使用），结果与find_block一致
+    // 调用方须保证设备的寻道模型、缓冲区与索引容器的实际类型恰为Model、Cache与Container
+    template <typename Model, typename Cache, typename Container>
+    std::pair<size_t, double> find_block_as(TapeDevice& tape, uint64_t data_id);
+    
+    const IndexContainer& get_container() const { return *index_map; }
+    
+    // 只读取已写入的索引页并解码，重建内存容器（挂载时代替整盘扫描），返回模拟耗时
+    // 尚未写出的条目直接取自内存；解码耗时记入page_stats.decode_ns
+    double load_index(TapeDevice& tape);
+    
+    const IndexPageStats& get_page_stats() const { return page_stats; }
+    
+protected:
+    std::pair<size_t, double> resolve_position(TapeDevice& tape, uint64_t data_id) override;
+};
+
+// 分层索引策略
+class HierarchicalIndexStrategy final : public IndexStrategy {
+private:
+    size_t level1_interval;  // 一级索引间隔（每个一级块描述的二级块数）
+    size_t level2_interval;  // 二级索引间隔（每个二级块描述的数据块数）
+    // 数据ID到数据块序号的映射，由序号得到(一级块, 二级块)；磁带上的索引块只存位置不存ID，
+    // 因此ID解析仍依赖这张常驻内存的完整映射，内存占用随数据块数线性增长
+    std::unique_ptr<IndexContainer> index_map;
+    std::vector<BlockAddress> level1_blocks;    // 一级索引块地址（内存中只保留这一层）
+    size_t level2_block_count = 0;              // 二级索引块数
+    
+    // 分段：每次build_index结束时把未满的组写出，之后追加的数据块从新的一段开始分组
+    // 段内除最后一组外都是满组，序号到(一级块, 槽位)可直接计算
+    struct Segment {
+        uint64_t first_ordinal;  // 段内第一个数据块序号
+        size_t first_level1;     // 段内第一个一级块下标
+    };
+    std::vector<Segment> segments;
+    uint64_t ordinal_count = 0;                 // 已索引的数据块数
+    std::vector<uint64_t> open_level2;          // 未写出的二级组：数据块位置
+    std::vector<uint64_t> open_level1;          // 未写出的一级组：二级块位置
+    TapeRegion index_region = TapeRegion::Data; // 索引块所在区域
+    size_t last_anchor = 0;                     // 最近一个数据块的位置（穿插放置的锚点）
+    
+    // 记录一个数据块，组满时写出二级块，二级块攒满时写出一级块
+    double add_data_block(TapeDevice& tape, size_t position);
+    
+    // 写出未满的二级组、一级组，并开始新的一段
+    double flush_open_groups(TapeDevice& tape);
+    
+    double write_level2(TapeDevice& tape);
+    double write_level1(TapeDevice& tape);
+    
+public:
+    HierarchicalIndexStrategy(size_t level1 = 100, size_t level2 = 10, const std::string& container = "hash");
+    
+    double build_index(TapeDevice& tape) override;
+    std::pair<size_t, double> find_block(TapeDevice& tape, uint64_t data_id) override;
+    bool supports_append() const override { return true; }
+    double on_append(TapeDevice& tape, const TapeBlockView& block, size_t position) override;
+    bool supports_position_lookup() const override { return true; }
+    
+    // 一批查询只读取一次两级索引块
+    void resolve_positions(TapeDevice& tape, const std::vector<uint64_t>& data_ids,
+                           std::vector<size_t>& positions, std::vector<double>& times) override;
+    std::string get_name() const override;
+    std::string get_stats() const override;
+    size_t memory_bytes() const override;
+    
+protected:
+    std::pair<size_t, double> resolve_position(TapeDevice& tape, uint64_t data_id) override;
+    
+private:
+    // 经一级、二级索引块解析数据块序号对应的位置；loaded记录本批次已读过的索引块，已读过的不再计时
+    // 尚未写出的组直接从内存中解析
+    std::pair<size_t, double> lookup_ordinal(TapeDevice& tape, uint64_t ordinal,
+                                             std::unordered_set<uint64_t>* loaded);
+    
+    // 读取索引块中第slot个u64条目；charge为false时该块本批次已读过，不再计时
+    uint64_t read_slot(TapeDevice& tape, const BlockAddress& address, size_t slot, bool charge, bool top_level,
+                       double& time);
+};
+
+// B+树索引策略：索引节点序列化后按放置方式写入索引块，查找时从根节点逐层定位并读取节点
+// 节点格式（主机字节序）：u8 是否叶子 | 3字节保留 | u32 条目数 | 条目[条目数]{u64 键, u64 值}
+// 叶子条目的值为数据块位置，内部节点条目的键为子树最小键、值为子节点块位置
+class BTreeIndexStrategy final : public IndexStrategy {
+public:
+    static const size_t NODE_HEADER_BYTES = 8;
+    static const size_t NODE_ENTRY_BYTES = 16;
+    static const uint64_t NODE_BLOCK_ID_BASE = 3000000;  // 索引节点块ID起始值
+    
+private:
+    size_t fan_out;                              // 配置的节点扇出（0表示按块大小取最大）
+    size_t effective_fan_out = 0;                // 实际扇出
+    TapeRegion node_region = TapeRegion::Data;   // 节点所在区域（全部节点同区域）
+    size_t root_position = std::string::npos;    // 根节点块位置（区域内）
+    size_t height = 0;                           // 树高（只有叶子层时为1）
+    size_t node_count = 0;                       // 节点数
+    size_t entry_count = 0;                      // 叶子条目数
+    size_t index_bytes = 0;                      // 索引块总字节数
+    
+    // 写入一层节点，time累加写入耗时，返回上一层的(子树最小键, 节点位置)
+    // B+树节点没有对应的数据区段，穿插放置时全部锚定在anchor（最后一个数据块）之后
+    std::vector<std::pair<uint64_t, uint64_t>> write_level(TapeDevice& tape,
+                                                           const std::vector<std::pair<uint64_t, uint64_t>>& entries,
+                                                           bool leaf, size_t anchor, double& time);
+    
+public:
+    BTreeIndexStrategy(size_t fan_out = 0);
+    
+    double build_index(TapeDevice& tape) override;
+    std::pair<size_t, double> find_block(TapeDevice& tape, uint64_t data_id) override;
+    bool supports_position_lookup() const override { return true; }
+    std::string get_name() const override;
+    std::string get_stats() const override;
+    
+protected:
+    std::pair<size_t, double> resolve_position(TapeDevice& tape, uint64_t data_id) override;
+};
+
+// 学习型索引策略（PGM风格）：把按ID排序的(块ID, 位置)拟合为误差不超过error块的分段线性模型
+// 分段写入少量索引块，内存只保留每个分段块的首键与地址；查询读取一个分段块得到预测位置，只在误差窗口内顺序扫描
+// 磁带上ID按批次单调写入时分段数约等于批次数；ID随机时几乎每两个条目一段，退化为稀疏的位置表
+class LearnedIndexStrategy final : public IndexStrategy {
+public:
+    static const size_t SEGMENT_HEADER_BYTES = 8;
+    static const size_t SEGMENT_BYTES = 24;                  // 首键、首位置、斜率
+    static const uint64_t SEGMENT_BLOCK_ID_BASE = 4000000;   // 分段块ID起始值
+    
+    // 一个线性分段：键k的预测位置为first_position + slope * (k - first_key)
+    struct Segment {
+        uint64_t first_key;
+        uint64_t first_position;
+        double slope;
+    };
+    
+    // 按键升序且键唯一的entries拟合分段：每段锚定首点，斜率取使段内全部点误差不超过error的区间中点
+    static std::vector<Segment> fit_segments(const std::vector<std::pair<uint64_t, uint64_t>>& entries,
+                                             size_t error);
+    
+private:
+    size_t error;                                // 模型误差上界（块）
+    std::vector<uint64_t> page_first_keys;       // 每个分段块第一个分段的首键（常驻内存）
+    std::vector<BlockAddress> page_addresses;    // 分段块地址
+    size_t segment_count = 0;
+    size_t entry_count = 0;
+    size_t index_bytes = 0;
+    size_t data_end = 0;                         // 构建时的块数，扫描窗口不越过此位置
+    size_t window_lookups = 0;                   // 进入窗口扫描的查询数
+    size_t window_blocks_read = 0;               // 窗口扫描读取的块数
+    
+public:
+    explicit LearnedIndexStrategy(size_t error = 16);
+    
+    double build_index(TapeDevice& tape) override;
+    std::pair<size_t, double> find_block(TapeDevice& tape, uint64_t data_id) override;
+    std::string get_name() const override;
+    std::string get_stats() const override;
+    size_t memory_bytes() const override;
+    
+    size_t get_segment_count() const { return segment_count; }
+    
+    // 每次窗口扫描平均读取的块数
+    double average_window_blocks() const {
+        return window_lookups > 0 ? static_cast<double>(window_blocks_read) / window_lookups : 0.0;
+    }
+};
+
+// 成员过滤器包装：在查询触及磁带之前先查过滤器，过滤器否定的ID直接返回未找到且不产生设备耗时
+// 构建时在内部策略之后再顺序扫描一遍磁带收集数据块ID；追加写入时同步插入过滤器
+class FilteredIndexStrategy final : public IndexStrategy {
+private:
+    std::unique_ptr<IndexStrategy> inner;
+    std::unique_ptr<MembershipFilter> filter;
+    FilterStats stats;
+    
+    // 记录一次查询的结果：通过过滤器但未找到的计为误判
+    void record(bool passed, size_t position);
+    
+public:
+    FilteredIndexStrategy(std::unique_ptr<IndexStrategy> inner, std::unique_ptr<MembershipFilter> filter);
+    
+    double build_index(TapeDevice& tape) override;
+    std::pair<size_t, double> find_block(TapeDevice& tape, uint64_t data_id) override;
+    std::vector<std::pair<size_t, double>> find_blocks(TapeDevice& tape, const std::vector<uint64_t>& data_ids,
+                                                       BatchSchedule schedule = BatchSchedule::LOOK,
+                                                       BatchStats* stats = nullptr) override;
+    bool supports_append() const override { return inner->supports_append(); }
+    double on_append(TapeDevice& tape, const TapeBlockView& block, size_t position) override;
+    bool supports_position_lookup() const override { return inner->supports_position_lookup(); }
+    void resolve_positions(TapeDevice& tape, const std::vector<uint64_t>& data_ids,
+                           std::vector<size_t>& positions, std::vector<double>& times) override;
+    std::string get_name() const override;
+    std::string get_stats() const override;
+    size_t memory_bytes() const override { return inner->memory_bytes() + filter->memory_bytes(); }
+    size_t index_blocks_written() const override { return inner->index_blocks_written(); }
+    size_t index_bytes_written() const override { return inner->index_bytes_written(); }
+    FilterStats get_filter_stats() const override;
+};
+
+// 查询流水线：一次调用执行一串查询，内层循环不经虚函数分派
+class QueryPipeline {
+public:
+    virtual ~QueryPipeline() = default;
+    
+    // 按顺序逐个查询（不重排），results[i]与依次调用find_block(tape, data_ids[i])的结果一致
+    virtual void run(TapeDevice& tape, const std::vector<uint64_t>& data_ids,
+                     std::vector<std::pair<size_t, double>>& results) = 0;
+    
+    // 特化组合的描述，如 "fixed/sorted/piecewise/none"
+    virtual std::string get_name() const = 0;
+};
+
+// 编译期特化的模拟器：Strategy、Model（寻道模型）、Cache（缓冲区）与Container（索引容器，仅fixed使用）为实际类型
+// fixed的整条查询路径（容器查找、寻道、读取）按静态类型内联且跳过边界检查；其他策略只消除策略本身的虚函数分派
+template <typename Strategy, typename Model = SeekModel, typename Cache = BlockCache, typename Container = IndexContainer>
+class Simulator final : public QueryPipeline {
+private:
+    Strategy& strategy;
+    std::string name;
+    
+public:
+    Simulator(Strategy& strategy, std::string name) : strategy(strategy), name(std::move(name)) {}
+    
+    void run(TapeDevice& tape, const std::vector<uint64_t>& data_ids,
+             std::vector<std::pair<size_t, double>>& results) override {
+        results.clear();
+        results.reserve(data_ids.size());
+        for (uint64_t id : data_ids) {
+            if constexpr (std::is_same_v<Strategy, FixedIntervalIndexStrategy>) {
+                results.push_back(strategy.template find_block_as<Model, Cache, Container>(tape, id));
+            } else {
+                results.push_back(strategy.Strategy::find_block(tape, id));
+            }
+        }
+    }
+    
+    std::string get_name() const override { return name; }
+};
+
+// 特化流水线工厂：按策略、寻道模型、缓冲区与索引容器的实际类型选择已实例化的Simulator
+// 组合未特化时（如带成员过滤器的策略或其他寻道模型）返回nullptr，调用方使用虚函数接口
+class QueryPipelineFactory {
+public:
+    static std::unique_ptr<QueryPipeline> create_pipeline(IndexStrategy& strategy, const TapeDevice& tape);
+};
+
+// 索引策略工厂
+class IndexStrategyFactory {
+public:
+    // container为索引策略使用的索引容器类型（见IndexContainerFactory）
+    static std::unique_ptr<IndexStrategy> create_strategy(const std::string& type, 
+                                                         size_t param1 = 0, 
+                                                         size_t param2 = 0,
+                                                         const std::string& container = "hash");
+};
+
+// 模拟结果结构
+// HDR风格的对数分桶直方图：小于2^SUB_BUCKET_BITS的值精确记录，更大的值按2的幂分段、
+// 每段再等分为2^(SUB_BUCKET_BITS-1)个子桶，相对误差不超过2^-(SUB_BUCKET_BITS-1)
+// 计数数组按需增长，两个直方图合并只需逐桶相加
+class LogHistogram {
+public:
+    static constexpr unsigned SUB_BUCKET_BITS = 7;
+    
+    void record(uint64_t value, uint64_t count = 1);
+    void merge(const LogHistogram& other);
+    
+    uint64_t count() const { return total; }
+    uint64_t min() const { return total > 0 ? min_value : 0; }
+    uint64_t max() const { return max_value; }
+    double mean() const { return total > 0 ? static_cast<double>(sum) / total : 0.0; }
+    
+    // 分位数q（0~1）：不小于q比例记录值的最小桶上界（不超过记录的最大值）
+    uint64_t percentile(double q) const;
+    
+    bool operator==(const LogHistogram& other) const;
+    
+private:
+    std::vector<uint64_t> counts;
+    uint64_t total = 0;
+    uint64_t min_value = UINT64_MAX;
+    uint64_t max_value = 0;
+    long double sum = 0;
+    
+    static size_t bucket_of(uint64_t value);
+    static uint64_t bucket_upper(size_t bucket);
+};
+
+// 每次查询的指标分布：模拟访问时间（纳秒）、寻道距离（物理块）、读取块数与字节数
+// 批量查询时一批的寻道和读取量在批内查询间平均分摊
+struct QueryMetrics {
+    LogHistogram latency_ns;
+    LogHistogram seek_distance;
+    LogHistogram blocks_read;
+    LogHistogram bytes_read;
+    
+    // 记录一次查询（time为模拟秒）
+    void record(double time, uint64_t distance, uint64_t blocks, uint64_t bytes);
+    
+    // 合并其他工作线程的统计
+    void merge(const QueryMetrics& other);
+    
+    // 访问时间分位数（秒）
+    double latency_percentile(double q) const { return latency_ns.percentile(q) / 1e9; }
+};
+
+// 当前线程已消耗的CPU时间（毫秒）
+static double thread_cpu_ms();
+
+// 主机CPU计时统计：调用次数、主机CPU时间与同一调用的模拟时间
+// 对比两者可以区分"模拟器本身慢"与"模拟的磁带慢"
+struct HostTimerStats {
+    size_t calls = 0;
+    double host_cpu_ms = 0.0;        // 当前线程消耗的主机CPU时间（毫秒）
+    double simulated_seconds = 0.0;  // 调用返回的模拟耗时（秒）
+};
+
+// 作用域计时器：构造到析构之间当前线程的CPU时间计入stats（TAPE_INSTRUMENTATION关闭时不计时）
+class ScopedHostTimer {
+private:
+    HostTimerStats* stats;
+    double start = 0.0;
+    
+public:
+    explicit ScopedHostTimer(HostTimerStats& stats);
+    ~ScopedHostTimer();
+    
+    ScopedHostTimer(const ScopedHostTimer&) = delete;
+    ScopedHostTimer& operator=(const ScopedHostTimer&) = delete;
+    
+    // 计入本次调用的模拟耗时
+    void add_simulated(double seconds) { TAPE_COUNT(stats->simulated_seconds += seconds); }
+};
+
+struct SimulationResult {
+    std::string strategy_name;
+    double index_build_time;      // 索引构建时间
+    double average_access_time;   // 平均访问时间
+    size_t total_seeks;           // 查询阶段磁带实际重新定位的次数
+    size_t total_blocks_accessed; // 总访问块数
+    double total_access_time;     // 总访问时间
+    double schedule_cpu_ms = 0.0; // 批量调度消耗的主机CPU时间（毫秒）
+    size_t cache_hits = 0;        // 查询阶段的设备缓存命中次数
+    size_t cache_misses = 0;      // 查询阶段的设备缓存未命中次数
+    size_t index_memory_bytes = 0; // 查询结束时策略常驻主机内存的索引字节数
+    size_t index_tape_blocks = 0;  // 策略写到磁带上的索引块数
+    size_t index_tape_bytes = 0;   // 策略写到磁带上的索引数据字节数
+    FilterStats filter;            // 成员过滤器统计
+    QueryMetrics metrics;          // 每次查询的指标分布
+    std::vector<double> query_times; // 每次查询的模拟访问时间（秒），仅在set_keep_query_times(true)时记录
+    DeviceIoStats build_io;        // 索引构建阶段的设备热路径计数器
+    DeviceIoStats io;              // 查询阶段的设备热路径计数器
+    HostTimerStats build_timer;    // build_index的主机CPU计时
+    HostTimerStats query_timer;    // find_block/find_blocks的主机CPU计时
+};
+
+// 计数器导出：收集带标签的样本，输出为JSON或Prometheus文本格式
+class MetricsExport {
+public:
+    using Labels = std::vector<std::pair<std::string, std::string>>;
+    
+    // type取 "counter" / "gauge"；同名样本应使用相同的help和type
+    void add(const std::string& name, const std::string& help, const std::string& type,
+             const Labels& labels, double value);
+    
+    // 一次模拟的设备计数器、缓存统计和主机计时，标签为strategy、phase（build/query）及extra_labels
+    void add_result(const SimulationResult& result, const Labels& extra_labels = {});
+    
+    // {"instrumentation": bool, "metrics": [{"name", "type", "labels", "value"}, ...]}
+    std::string to_json() const;
+    
+    // Prometheus文本格式：每个指标名一组HELP/TYPE，后接各带标签的样本
+    std::string to_prometheus() const;
+    
+private:
+    struct Sample {
+        std::string name;
+        std::string help;
+        std::string type;
+        Labels labels;
+        double value;
+    };
+    std::vector<Sample> samples;
+};
+
+// 参数扫描中的一组策略配置
+struct StrategyConfig {
+    std::string type;   // 策略类型（同IndexStrategyFactory）
+    size_t param1 = 0;  // 策略参数1
+    size_t param2 = 0;  // 策略参数2
+    std::string container = "hash";  // 索引容器类型
+    IndexPlacement placement = IndexPlacement::End;  // 索引块放置方式
+    IndexCachePolicy cache_policy = IndexCachePolicy::None;  // 索引块缓存策略
+    size_t cache_blocks = 0;  // LRU策略保留的索引块数
+    std::string filter = "none";  // 成员过滤器类型（见MembershipFilterFactory）
+    size_t filter_bits_per_key = 10;  // 过滤器每个键的位数
+};
+
+// 工作窃取线程池：每个工作线程有自己的任务队列，从队尾取任务，空闲时从其他队列队首窃取
+class WorkStealingPool {
+private:
+    struct TaskQueue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+    
+    std::vector<std::unique_ptr<TaskQueue>> queues;
+    
+    // 取出一个任务：优先本线程队列，其次窃取
+    bool take_task(size_t worker, std::function<void()>& task);
+    
+public:
+    explicit WorkStealingPool(size_t thread_count);
+    
+    size_t thread_count() const { return queues.size(); }
+    
+    // 执行全部任务并等待完成；任务抛出的第一个异常在全部任务结束后重新抛出
+    void run(std::vector<std::function<void()>> tasks);
+};
+
+// 磁带模拟器
+class TapeSimulator {
+private:
+    TapeDevice tape_device;
+    std::unique_ptr<IndexStrategy> current_strategy;
+    std::vector<SimulationResult> results;
+    uint64_t data_seed = 1;  // 测试数据种子（固定种子保证可复现）
+    size_t id_batch_blocks = 0;  // 单调ID批次长度（0表示每块独立随机ID）
+    size_t batch_window = 0;  // 批量查询窗口（0表示逐个查询）
+    BatchSchedule batch_schedule = BatchSchedule::LOOK;  // 批量查询调度方式
+    double rao_time_budget_ms = 2.0;  // RAO每批求解时间上限（主机毫秒）
+    bool keep_query_times = false;  // 是否在结果中保留每次查询的原始访问时间
+    
+    // 生成测试数据
+    void generate_test_data(size_t block_count, double data_size_ratio = 0.5);
+    
+    // 在指定设备上构建索引并执行查询
+    SimulationResult simulate(TapeDevice& tape, IndexStrategy& strategy,
+                              const std::vector<uint64_t>& query_ids) const;
+    
+public:
+    TapeSimulator(size_t block_size = 4096);
+    
+    // 设置索引策略
+    void set_strategy(std::unique_ptr<IndexStrategy> strategy);
+    
+    // 设置磁带数据存放模式（清空当前磁带）
+    void set_payload_mode(PayloadMode mode);
+    
+    // 设置测试数据种子（默认1），相同种子生成相同的磁带
+    void set_data_seed(uint64_t seed) { data_seed = seed; }
+    
+    // 设置测试数据的ID布局：batch_blocks>0时每batch_blocks个块为一批，
+    // 批内ID从随机起点按1到8的随机间隔递增；0为每块在[1, 1000000]内独立随机（默认）
+    void set_id_batch_blocks(size_t batch_blocks) { id_batch_blocks = batch_blocks; }
+    
+    // 生成测试数据并保存为磁带镜像
+    void save_test_image(const std::string& path, size_t block_count);
+    
+    // 加载磁带镜像作为当前磁带
+    void load_image(const std::string& path);
+    
+    // 获取当前磁带
+    const TapeDevice& get_tape() const { return tape_device; }
+    
+    // 设置磁带的磁道几何（blocks_per_wrap为0表示单条正向磁道）
+    void set_geometry(size_t blocks_per_wrap) { tape_device.set_geometry(TapeGeometry(blocks_per_wrap)); }
+    
+    // 设置磁带的设备缓存（并行对比的各游标使用相同配置的空缓存）
+    void set_device_cache(const DeviceCacheConfig& config) { tape_device.set_cache(config); }
+    
+    // 设置磁带的寻道模型（见SeekModelFactory）
+    void set_seek_model(const std::string& type) { tape_device.set_seek_model(SeekModelFactory::create_seek_model(type)); }
+    
+    // 格式化当前磁带开头的索引分区（capacity块，0表示取消分区）
+    void format_index_partition(size_t capacity) { tape_device.format_index_partition(capacity); }
+    
+    // 生成测试数据作为当前磁带
+    void generate_tape(size_t block_count) { generate_test_data(block_count); }
+    
+    // 从当前磁带的数据块中随机抽取count个ID（用于命中查询）
+    std::vector<uint64_t> sample_stored_ids(size_t count, uint64_t seed) const;
+    
+    // 当前磁带全部数据块的ID（按磁带位置顺序，用作工作负载的键空间）
+    std::vector<uint64_t> stored_ids() const;
+    
+    // 设置批量查询：每window个查询作为一批，按schedule调度物理访问（window为0时逐个查询）
+    void set_batch_mode(size_t window, BatchSchedule schedule = BatchSchedule::LOOK) {
+        batch_window = window;
+        batch_schedule = schedule;
+    }
+    
+    // 设置RAO每批求解时间上限（主机毫秒）
+    void set_rao_time_budget(double ms) { rao_time_budget_ms = ms; }
+    
+    // 设置是否在SimulationResult::query_times中保留每次查询的原始访问时间（用于核对直方图分位数）
+    void set_keep_query_times(bool keep) { keep_query_times = keep; }
+    
+    // 运行模拟
+    SimulationResult run_simulation(size_t block_count, 
+                                   const std::vector<uint64_t>& query_ids,
+                                   bool generate_new_data = true);
+    
+    // 运行对比模拟
+    std::vector<SimulationResult> run_comparison(size_t block_count,
+                                                const std::vector<uint64_t>& query_ids,
+                                                const std::vector<std::string>& strategy_types);
+    
+    // 在当前磁带（如已加载的镜像）上运行对比模拟
+    std::vector<SimulationResult> run_comparison(const std::vector<uint64_t>& query_ids,
+                                                const std::vector<std::string>& strategy_types);
+    
+    // 并行对比：各配置在工作窃取线程池中运行，每个任务使用共享当前磁带块数据的独立游标和策略实例
+    // 每个配置都从未写入索引块的当前磁带、位置0开始，结果按configs顺序返回
+    std::vector<SimulationResult> run_parallel_comparison(const std::vector<uint64_t>& query_ids,
+                                                         const std::vector<StrategyConfig>& configs,
+                                                         size_t thread_count = 0);
+    
+    // 打印结果
+    void print_results() const;
+
+    // 基准测试：测量索引构建时间（返回毫秒）
+    double benchmark_index_build(size_t block_count) {
+        generate_test_data(block_count);
+        auto start = std::chrono::high_resolution_clock::now();
+        current_strategy->build_index(tape_device);
+        auto end = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    }
+
+    // 基准测试：测量查询性能（返回毫秒）
+    double benchmark_queries(const std::vector<uint64_t>& query_ids) {
+        auto start = std::chrono::high_resolution_clock::now();
+        for (uint64_t id : query_ids) {
+            current_strategy->find_block(tape_device, id);
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    }
+};
+
+// 工作负载参数（各生成器只使用与自己相关的字段）
+struct WorkloadConfig {
+    uint64_t seed = 1;              // 随机种子（固定种子保证可复现）
+    double miss_ratio = 0.0;        // 查询磁带上不存在的ID的比例
+    double zipf_theta = 0.99;       // Zipf偏斜度，取[0, 1)，0为均匀
+    size_t mean_run_length = 16;    // 顺序访问每段的平均连续块数
+    double hot_fraction = 0.1;      // 热点区占键空间的比例（磁带上连续的一段）
+    double hot_probability = 0.9;   // 访问落在热点区的概率
+    double recent_fraction = 0.05;  // 最近写入偏好：访问与磁带末尾的平均距离（占键空间比例）
+};
+
+// 查询ID流：生成器无限产生ID，轨迹回放在文件结束时返回false
+class WorkloadGenerator {
+public:
+    virtual ~WorkloadGenerator() = default;
+    
+    // 取下一个查询ID，没有更多查询时返回false
+    virtual bool next(uint64_t& block_id) = 0;
+    
+    virtual std::string get_name() const = 0;
+    
+    // 取最多count个查询ID
+    std::vector<uint64_t> take(size_t count);
+};
+
+// 在键空间（按磁带位置排列的数据块ID）上按位置分布抽样的生成器基类
+class KeySpaceWorkload : public WorkloadGenerator {
+protected:
+    std::vector<uint64_t> keys;
+    WorkloadConfig config;
+    std::mt19937_64 gen;
+    uint64_t miss_base;  // 未命中ID从最大键之后开始取
+    
+    // 按分布抽取下一个键的位置
+    virtual size_t next_position() = 0;
+    
+public:
+    KeySpaceWorkload(std::vector<uint64_t> keys, const WorkloadConfig& config);
+    
+    bool next(uint64_t& block_id) override;
+};
+
+// 均匀分布
+class UniformWorkload : public KeySpaceWorkload {
+protected:
+    size_t next_position() override;
+    
+public:
+    using KeySpaceWorkload::KeySpaceWorkload;
+    std::string get_name() const override { return "uniform"; }
+};
+
+// Zipf分布（Gray等人的快速生成算法），按种子打乱排名到位置的映射，热键分散在磁带上
+class ZipfWorkload : public KeySpaceWorkload {
+private:
+    std::vector<size_t> rank_to_position;
+    double alpha;
+    double zeta_n;
+    double eta;
+    
+protected:
+    size_t next_position() override;
+    
+public:
+    ZipfWorkload(std::vector<uint64_t> keys, const WorkloadConfig& config);
+    std::string get_name() const override { return "zipf"; }
+};
+
+// 顺序段：随机起点后连续访问，段长服从均值为mean_run_length的几何分布
+class SequentialWorkload : public KeySpaceWorkload {
+private:
+    size_t position = 0;
+    size_t remaining = 0;
+    
+protected:
+    size_t next_position() override;
+    
+public:
+    using KeySpaceWorkload::KeySpaceWorkload;
+    std::string get_name() const override { return "sequential"; }
+};
+
+// 热点区：hot_probability的访问均匀落在一段连续热点区，其余均匀落在热点区之外
+class HotspotWorkload : public KeySpaceWorkload {
+private:
+    size_t hot_begin;
+    size_t hot_count;
+    
+protected:
+    size_t next_position() override;
+    
+public:
+    HotspotWorkload(std::vector<uint64_t> keys, const WorkloadConfig& config);
+    std::string get_name() const override { return "hotspot"; }
+};
+
+// 最近写入偏好：与磁带末尾的距离服从指数分布
+class RecentWorkload : public KeySpaceWorkload {
+protected:
+    size_t next_position() override;
+    
+public:
+    using KeySpaceWorkload::KeySpaceWorkload;
+    std::string get_name() const override { return "recent"; }
+};
+
+// 访问轨迹记录
+struct TraceRecord {
+    double timestamp;   // 访问时刻（秒，CSV中缺省为0）
+    uint64_t block_id;  // 访问的块ID
+};
+
+// 二进制轨迹文件：8字节魔数后为连续的{double timestamp; uint64_t block_id}记录（小端）
+constexpr char TRACE_MAGIC[8] = {'F', 'T', 'T', 'R', 'A', 'C', 'E', '1'};
+
+// 流式轨迹回放：按文件开头的魔数区分二进制与CSV格式，逐条读取，不整体载入内存
+// CSV每行为 "block_id" 或 "timestamp,block_id"；空行、'#'开头的注释行和首行表头被跳过
+class TraceReader : public WorkloadGenerator {
+private:
+    std::ifstream in;
+    std::string path;
+    bool binary = false;
+    size_t line_number = 0;
+    size_t record_count = 0;
+    
+public:
+    explicit TraceReader(const std::string& path);
+    
+    // 读取下一条记录，文件结束时返回false；格式错误时抛出runtime_error
+    bool next_record(TraceRecord& record);
+    
+    bool next(uint64_t& block_id) override;
+    std::string get_name() const override { return "trace"; }
+    size_t records_read() const { return record_count; }
+};
+
+// 写出轨迹文件（binary为false时写CSV）
+void write_trace(const std::string& path, const std::vector<TraceRecord>& records, bool binary);
+
+// 工作负载工厂：type取 "uniform" / "zipf" / "sequential" / "hotspot" / "recent"
+class WorkloadFactory {
+public:
+    static std::unique_ptr<WorkloadGenerator> create_workload(const std::string& type,
+                                                              std::vector<uint64_t> keys,
+                                                              const WorkloadConfig& config = WorkloadConfig());
+};
+
+// 基准测试用例：在block_count块的合成磁带上，用workload的查询测量strategy（container）
+struct BenchmarkCase {
+    size_t block_count;
+    std::string strategy;
+    std::string container;  // 仅fixed使用，其余策略为"hash"
+    std::string workload;
+    
+    // 用例名，如 "fixed/eytzinger/zipf/10000"，用于与基线对应
+    std::string name() const;
+};
+
+// 基准测试结果：主机耗时取各次重复的中位数，模拟耗时在给定种子下是确定的
+struct BenchmarkResult {
+    BenchmarkCase config;
+    double build_ns_per_block = 0.0;       // 构建索引的主机耗时（每数据块纳秒）
+    double query_ns_per_op = 0.0;          // 查询的主机耗时（每次查询纳秒，重复中位数）
+    double query_ns_per_op_min = 0.0;      // 查询的主机耗时（重复最小值）
+    double build_allocations = 0.0;        // 构建索引期间的分配次数
+    double allocations_per_query = 0.0;    // 每次查询的分配次数
+    double bytes_per_entry = 0.0;          // 索引常驻内存（每数据块字节）
+    double simulated_access_time = 0.0;    // 平均模拟访问时间（秒）
+};
+
+// 与基线对比的结论
+struct BenchmarkComparison {
+    std::string name;
+    double baseline_ns = 0.0;  // 基线查询耗时（每次查询纳秒，重复最小值）
+    double current_ns = 0.0;
+    bool regressed = false;   // 查询主机耗时超出基线的容差
+    bool changed = false;     // 模拟访问时间与基线不同（模拟行为发生变化）
+    bool missing = false;     // 基线中的用例本次没有运行（current_ns为0）
+};
+
+// 基准测试套件：scale取 "quick"（1e3~1e4块）/ "standard"（1e3~1e6块）/ "full"（1e3~1e8块）
+// 各规模覆盖fixed（各索引容器）、hierarchical、btree（1e4块以下另含none）与uniform/zipf工作负载
+class BenchmarkSuite {
+public:
+    explicit BenchmarkSuite(const std::string& scale, size_t repetitions = 5, size_t query_count = 10000);
+    
+    const std::vector<BenchmarkCase>& get_cases() const { return cases; }
+    
+    // 运行全部用例（同一磁带规模上的用例共享磁带，不同工作负载共享已构建的索引）
+    std::vector<BenchmarkResult> run() const;
+    
+    // 输出为JSON，每个用例一行（load_baseline按行读取）
+    static std::string to_json(const std::string& scale, const std::vector<BenchmarkResult>& results);
+    
+    // 读取to_json写出的基线文件
+    static std::vector<BenchmarkResult> load_baseline(const std::string& path);
+    
+    // 按用例名与基线对比：查询主机耗时（重复最小值）的相对增幅超过tolerance为回归，
+    // 模拟访问时间不同为模拟行为变化；基线中有而current中没有的用例标记为缺失（排在最后）
+    static std::vector<BenchmarkComparison> compare(const std::vector<BenchmarkResult>& baseline,
+                                                    const std::vector<BenchmarkResult>& current,
+                                                    double tolerance);
+    
+private:
+    std::vector<BenchmarkCase> cases;
+    size_t repetitions;
+    size_t query_count;
+};
+
+// 写入流水线配置：时间单位为模拟秒，速度单位为字节/秒
+struct WritePipelineConfig {
+    size_t buffer_bytes = 1024 * 1024;   // 主机端暂存缓冲区容量（已成形、尚未写完的记录）
+    bool coalesce = true;                // 把小对象合并成block_size的记录；否则每个对象单独成记录
+    double host_rate = 2 * 1024 * 1024;  // 主机产生数据的速度
+    double host_object_overhead = 0.0;   // 主机处理每个对象的固定开销
+    double record_overhead = 0.002;      // 驱动器每条记录的固定开销（记录间隙）
+    double backhitch_time = 1.0;         // 缓冲区排空后停带、倒回、重新加速的耗时
+    double restart_fill = 0.5;           // 停带后缓冲区填到容量的这一比例才重新起转
+    double filemark_time = 0.05;         // 写一个文件标记的耗时
+};
+
+// 写入流水线统计
+struct WritePipelineStats {
+    size_t objects = 0;
+    size_t payload_bytes = 0;
+    size_t records = 0;
+    size_t filemarks = 0;
+    size_t underruns = 0;           // 缓冲区排空导致的停带（shoe-shining）次数
+    size_t sync_stops = 0;          // 同步点导致的停带次数
+    double backhitch_seconds = 0.0; // 停带后重新定位的总耗时
+    double drive_busy = 0.0;        // 驱动器写记录与文件标记的总耗时
+    double host_wait = 0.0;         // 主机因缓冲区满或等待同步而阻塞的总耗时
+    double elapsed = 0.0;           // 从第一个对象到最后一条记录写完的模拟时间
+    
+    // 有效写入吞吐量（字节/秒）
+    double throughput() const { return elapsed > 0 ? payload_bytes / elapsed : 0.0; }
+};
+
+// 写入流水线：主机对象先进入暂存缓冲区，合并成记录后由驱动器按流式写入TapeDevice
+// 主机与驱动器各有时钟：缓冲区满时主机等待，缓冲区排空时驱动器停带并在重新起转前付出backhitch_time
+// 同步点把不满的记录写出、写文件标记，等驱动器排空后主机才继续；记录的块ID取记录中第一个对象的ID
+// 只写合成载荷，磁带需处于合成模式；文件标记只记录位置，不占用磁带块
+class WritePipeline {
+public:
+    WritePipeline(TapeDevice& tape, const WritePipelineConfig& config = {});
+    
+    // 主机提交一个对象
+    void submit(uint64_t object_id, size_t size);
+    
+    // 同步点：写出暂存数据并写文件标记
+    void sync();
+    
+    // 写出剩余数据（不写文件标记），返回统计
+    const WritePipelineStats& finish();
+    
+    const WritePipelineStats& get_stats() const { return stats; }
+    
+    // 各文件标记之前的数据块数
+    const std::vector<size_t>& get_filemark_positions() const { return filemark_positions; }
+    
+private:
+    // 已成形、等待驱动器开始写入的记录
+    struct StagedRecord {
+        uint64_t block_id;
+        size_t bytes;
+        double ready;  // 记录完整进入缓冲区的主机时刻
+    };
+    
+    TapeDevice& tape;
+    WritePipelineConfig config;
+    WritePipelineStats stats;
+    std::vector<size_t> filemark_positions;
+    double host_clock = 0.0;
+    double drive_clock = 0.0;                           // 驱动器写完已调度记录的时刻
+    bool streaming = false;                             // 驱动器是否在流式运行（首次起转前为false，不计停带）
+    std::deque<StagedRecord> staged;
+    size_t staged_bytes = 0;
+    std::deque<std::pair<double, size_t>> in_flight;    // 已调度记录的(写完时刻, 字节数)，写完后释放缓冲区
+    size_t in_flight_bytes = 0;
+    size_t open_bytes = 0;                              // 正在合并的记录已有字节数
+    uint64_t open_id = 0;                               // 正在合并的记录的块ID
+    bool open_has_id = false;
+    
+    // 把记录放入缓冲区，缓冲区不足时主机等待驱动器写完更早的记录
+    void stage(uint64_t block_id, size_t bytes);
+    
+    // 关闭正在合并的记录
+    void close_open_record();
+    
+    // 调度驱动器写入已成形的记录；驱动器停带时须累积到起转阈值，force为true时立即写完全部记录
+    void drain(bool force);
+};
+
+// 对象在打包磁带上的位置：从容器块first_block内offset字节起、共length字节，可跨越后续容器块
+struct ObjectExtent {
+    size_t first_block;  // 容器块序号（见ObjectPacker::block_position）
+    uint32_t offset;
+    uint32_t length;
+};
+
+// 打包读取统计
+struct PackedReadStats {
+    size_t objects_found = 0;
+    size_t blocks_read = 0;
+    double time = 0.0;
+};
+
+// 对象打包层：把小对象按字节流依次装入block_size的容器块，对象ID映射到(块, 偏移, 长度)
+// 容器块以合成载荷追加写入数据分区，块ID取块中第一个字节所属对象的ID；同一ID再次写入时映射指向新位置
+// 读取时只定位并读取覆盖对象字节区间的块（磁带按整条记录传输，块内偏移不减少读取量）
+class ObjectPacker {
+public:
+    explicit ObjectPacker(TapeDevice& tape);
+    
+    // 追加一个对象，返回写出已满容器块的耗时
+    double add(uint64_t object_id, size_t size);
+    
+    // 写出未满的容器块，返回耗时
+    double flush();
+    
+    bool locate(uint64_t object_id, ObjectExtent& extent) const;
+    
+    // 容器块在数据分区中的位置
+    size_t block_position(size_t block) const { return positions.at(block); }
+    
+    // 在cursor（打包磁带或其游标）上读取一组对象：覆盖它们的容器块按位置去重排序后各读一次
+    // 对象所在块尚未写出时抛出std::logic_error
+    PackedReadStats read_objects(TapeDevice& cursor, const std::vector<uint64_t>& object_ids) const;
+    
+    size_t get_object_count() const { return extents.size(); }
+    size_t get_payload_bytes() const { return payload_bytes; }  // 各对象当前版本的字节数
+    size_t get_superseded_bytes() const { return superseded_bytes; }  // 被重复添加覆盖的旧版本字节数
+    size_t get_block_count() const { return positions.size(); }
+    
+    // 对象目录常驻主机内存的字节数
+    size_t memory_bytes() const;
+    
+    // 空间利用率：对象当前版本的字节数 / 已写出容器块的容量
+    double space_efficiency() const;
+    
+private:
+    TapeDevice& tape;
+    std::unordered_map<uint64_t, ObjectExtent> extents;
+    std::vector<size_t> positions;  // 各容器块的数据分区位置（其他写入可能穿插其间）
+    size_t payload_bytes = 0;
+    size_t superseded_bytes = 0;
+    size_t open_bytes = 0;          // 未满容器块已有字节数
+    uint64_t open_id = 0;           // 未满容器块的块ID
+    bool open_has_id = false;
+    
+    double write_block(size_t bytes);
+};
+
+// 离散事件引擎：按(时刻, 提交顺序)从优先队列中取出事件执行，虚拟时钟跳到事件时刻
+// 同一时刻的事件按提交顺序执行，结果与主机线程调度无关
+class EventLoop {
+public:
+    using Action = std::function<void()>;
+    
+    // 当前虚拟时刻（模拟秒）
+    double now() const { return clock; }
+    
+    // 在time时刻执行action（time不能早于当前时刻）
+    void schedule_at(double time, Action action);
+    
+    // 在delay秒后执行action
+    void schedule_after(double delay, Action action) { schedule_at(clock + delay, std::move(action)); }
+    
+    // 执行到没有事件为止
+    void run();
+    
+    // 执行所有不晚于time的事件，然后把时钟推进到time
+    void run_until(double time);
+    
+    bool empty() const { return events.empty(); }
+    size_t processed() const { return processed_count; }
+    
+private:
+    struct Event {
+        double time;
+        uint64_t sequence;
+        Action action;
+    };
+    struct Later {
+        bool operator()(const Event& a, const Event& b) const {
+            return a.time > b.time || (a.time == b.time && a.sequence > b.sequence);
+        }
+    };
+    
+    std::priority_queue<Event, std::vector<Event>, Later> events;
+    double clock = 0.0;
+    uint64_t next_sequence = 0;
+    size_t processed_count = 0;
+    
+    void step();
+};
+
+// 串行资源（驱动器、机械手）：同一时刻只执行一个操作，其余按提交顺序排队
+// operation在开始时刻执行并返回持续时间（可直接调用TapeDevice/IndexStrategy中返回耗时的接口），
+// 结束时刻调用done
+class SimResource {
+public:
+    explicit SimResource(EventLoop& loop) : loop(&loop) {}
+    
+    void submit(std::function<double()> operation, std::function<void()> done);
+    
+    bool busy() const { return active; }
+    size_t queue_length() const { return waiting.size(); }
+    double busy_time() const { return busy_seconds; }        // 累计执行时间
+    double wait_time() const { return wait_seconds; }        // 操作累计排队时间
+    size_t completed() const { return completed_count; }
+    
+private:
+    struct Job {
+        std::function<double()> operation;
+        std::function<void()> done;
+        double submitted;
+    };
+    
+    EventLoop* loop;
+    std::deque<Job> waiting;
+    bool active = false;
+    double busy_seconds = 0.0;
+    double wait_seconds = 0.0;
+    size_t completed_count = 0;
+    
+    void start_next();
+};
+
+// 磁带库换盘调度：驱动器空闲且当前磁带没有待处理请求时，从未装入的磁带中选择下一盘
+enum class MountPolicy {
+    FIFO,      // 最早到达的待处理请求所在的磁带
+    MostQueued // 待处理请求最多的磁带（相同时取最早到达的）
+};
+
+// 换盘调度名称与解析
+const char* mount_policy_name(MountPolicy policy);
+MountPolicy parse_mount_policy(const std::string& name);
+
+// 磁带库配置：时间单位为模拟秒
+struct TapeLibraryConfig {
+    size_t drive_count = 4;                // 驱动器数
+    size_t cartridge_count = 16;           // 磁带数
+    size_t blocks_per_cartridge = 5000;    // 每盘数据块数（合成数据）
+    size_t block_size = 4096;              // 块大小
+    double robot_exchange_time = 10.0;     // 机械手在槽位与驱动器间搬运一次（卸下旧盘并装入新盘）
+    double load_time = 15.0;               // 驱动器装带并定位到磁带起点
+    double unload_time = 15.0;             // 驱动器退带（之前先回卷到起点）
+    size_t queue_depth = 32;               // 驱动器每次从当前磁带取出的最大请求数（作为一批调度）
+    std::vector<size_t> drive_queue_depths; // 各驱动器单独的队列深度；未给出或为0的驱动器使用queue_depth
+    MountPolicy mount_policy = MountPolicy::FIFO;
+    std::string strategy = "fixed";        // 每盘磁带的索引策略（见IndexStrategyFactory）
+};
+
+// 磁带库请求：arrival为到达时刻
+struct LibraryRequest {
+    double arrival;
+    size_t cartridge;
+    uint64_t block_id;
+};
+
+// 磁带库运行统计
+struct LibraryStats {
+    size_t completed = 0;            // 完成的请求数
+    size_t not_found = 0;            // 未找到的请求数
+    size_t mounts = 0;               // 装带次数
+    size_t events = 0;               // 离散事件引擎处理的事件数
+    double robot_wait = 0.0;         // 换盘请求等待机械手的累计时间
+    double makespan = 0.0;           // 第一个请求到达到最后一个请求完成
+    double queries_per_hour = 0.0;   // 吞吐量
+    double mean_latency = 0.0;       // 请求从到达到完成的平均时延
+    double p50_latency = 0.0;
+    double p95_latency = 0.0;
+    double p99_latency = 0.0;
+    double max_latency = 0.0;
+    double drive_utilization = 0.0;  // 驱动器忙碌（换盘或读取）时间占比
+};
+
+// 磁带库：多个驱动器、多盘磁带（各自的TapeDevice与索引策略）和一个共享的机械手
+// 在离散事件引擎上运行：请求到达、驱动器与机械手的操作完成都是事件，驱动器和机械手为串行资源
+// 机械手一次只能搬运一盘磁带；一盘磁带同一时刻只能装在一个驱动器中
+// 一批请求按LOOK调度在驱动器上执行，批内请求在整批完成时返回
+class TapeLibrary {
+private:
+    struct Cartridge {
+        TapeDevice tape;
+        std::unique_ptr<IndexStrategy> strategy;
+        std::vector<uint64_t> data_ids;  // 磁带上的数据块ID（用于生成请求）
+    };
+    
+    // 一次运行的状态
+    struct RunState;
+    
+    TapeLibraryConfig config;
+    std::vector<Cartridge> cartridges;
+    
+    // 为当前空闲的驱动器选择下一盘磁带；没有可装入的磁带时返回npos
+    size_t choose_cartridge(const std::vector<std::deque<size_t>>& pending,
+                            const std::vector<LibraryRequest>& requests,
+                            const std::vector<bool>& mounted) const;
+    
+    // 驱动器进程：有待处理请求时执行一批，否则换盘，都没有时进入空闲等待新请求
+    void drive_step(RunState& state, size_t drive);
+    
+public:
+    // 生成各盘磁带的合成数据并按配置的策略构建索引（构建耗时不计入运行统计）
+    TapeLibrary(const TapeLibraryConfig& config, uint64_t seed = 1);
+    
+    const TapeLibraryConfig& get_config() const { return config; }
+    
+    // 修改调度参数（不影响磁带内容）
+    // set_queue_depth让所有驱动器使用同一深度，set_drive_queue_depth只修改一个驱动器
+    void set_queue_depth(size_t depth) {
+        config.queue_depth = std::max<size_t>(1, depth);
+        std::fill(config.drive_queue_depths.begin(), config.drive_queue_depths.end(), 0);
+    }
+    void set_drive_queue_depth(size_t drive, size_t depth);
+    size_t get_drive_queue_depth(size_t drive) const;
+    void set_mount_policy(MountPolicy policy) { config.mount_policy = policy; }
+    
+    // 生成count个请求：到达间隔服从指数分布（每小时rate_per_hour个），磁带均匀选择，ID取自该盘已有的块
+    std::vector<LibraryRequest> generate_requests(size_t count, double rate_per_hour, uint64_t seed) const;
+    
+    // 执行请求序列（按到达时刻排序），所有磁带从未装入、磁头在起点的状态开始
+    LibraryStats run(const std::vector<LibraryRequest>& requests);
+};
+
+// PayloadArena 实现
+uint64_t PayloadArena::allocate(size_t size) {
+    if (used + size > capacity) {
+        reserve(std::max(used + size, capacity * 2));
+    }
+    uint64_t offset = used;
+    used += size;
+    return offset;
+}
+
+void PayloadArena::reserve(size_t bytes) {
+    if (bytes <= capacity) {
+        return;
+    }
+    
+    std::unique_ptr<uint8_t[]> grown(new uint8_t[bytes]);
+    if (used > 0) {
+        std::memcpy(grown.get(), buffer.get(), used);
+    }
+    buffer = std::move(grown);
+    capacity = bytes;
+}
+
+void fill_synthetic_payload(uint8_t* dst, size_t size, uint64_t seed) {
+    uint64_t state = seed;
+    for (size_t filled = 0; filled < size; filled += sizeof(uint64_t)) {
+        state += 0x9E3779B97F4A7C15ULL;
+        uint64_t z = state;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        z ^= z >> 31;
+        std::memcpy(dst + filled, &z, std::min(sizeof(z), size - filled));
+    }
+}
+
+// TapeBlockStore 实现
+void TapeBlockStore::push_metadata(uint64_t id, size_t size, bool is_index) {
+    if (size > std::numeric_limits<uint32_t>::max()) {
+        throw std::length_error("Block data too large");
+    }
+    
+    block_ids.push_back(id);
+    index_flags.push_back(is_index ? 1 : 0);
+    sizes.push_back(static_cast<uint32_t>(size));
+    offsets.push_back(total_bytes);
+    total_bytes += size;
+}
+
+size_t TapeBlockStore::append(uint64_t id, const uint8_t* data, size_t size, bool is_index) {
+    uint8_t* dst = emplace(id, size, is_index);
+    if (size > 0) {
+        std::memcpy(dst, data, size);
+    }
+    return this->size() - 1;
+}
+
+uint8_t* TapeBlockStore::emplace(uint64_t id, size_t size, bool is_index) {
+    if (size > std::numeric_limits<uint32_t>::max()) {
+        throw std::length_error("Block data too large");
+    }
+    
+    // 实体化模式下字节池偏移可由offsets列推出；合成模式下单独记录
+    uint64_t offset = payload.allocate(size);
+    if (mode == PayloadMode::Synthetic) {
+        resident_offsets[this->size()] = offset;
+    }
+    push_metadata(id, size, is_index);
+    return payload.data(offset);
+}
+
+size_t TapeBlockStore::append_synthetic(uint64_t id, size_t size, bool is_index) {
+    if (mode != PayloadMode::Synthetic) {
+        throw std::logic_error("Synthetic blocks require synthetic payload mode");
+    }
+    push_metadata(id, size, is_index);
+    return this->size() - 1;
+}
+
+void TapeBlockStore::reserve(size_t block_count, size_t payload_bytes) {
+    block_ids.reserve(block_count);
+    index_flags.reserve(block_count);
+    sizes.reserve(block_count);
+    offsets.reserve(block_count);
+    if (mode == PayloadMode::Materialized) {
+        payload.reserve(payload_bytes);
+    }
+}
+
+void TapeBlockStore::set_payload_mode(PayloadMode new_mode, uint64_t seed) {
+    if (size() != 0) {
+        throw std::logic_error("Payload mode can only be changed on an empty store");
+    }
+    mode = new_mode;
+    synthetic_seed = seed;
+}
+
+const uint8_t* TapeBlockStore::data(size_t index) const {
+    if (mode == PayloadMode::Materialized) {
+        if (index < base.count) {
+            return base.payload + base.offsets[index];
+        }
+        return payload.data(offsets[index - base.count] - base.total_bytes);
+    }
+    
+    auto it = resident_offsets.find(index);
+    if (it == resident_offsets.end()) {
+        return nullptr;
+    }
+    return index < base.count ? base.payload + it->second : payload.data(it->second);
+}
+
+void TapeBlockStore::copy_payload(size_t index, std::vector<uint8_t>& out) const {
+    out.resize(data_size(index));
+    const uint8_t* resident = data(index);
+    if (resident) {
+        std::copy(resident, resident + out.size(), out.begin());
+    } else {
+        fill_synthetic_payload(out.data(), out.size(), block_seed(index));
+    }
+}
+
+uint64_t TapeBlockStore::block_seed(size_t index) const {
+    return synthetic_seed ^ (static_cast<uint64_t>(index) * 0xD1B54A32D192ED03ULL);
+}
+
+size_t TapeBlockStore::find_data_block(size_t begin, size_t end, uint64_t target) const {
+    // 基础段
+    if (begin < base.count) {
+        size_t segment_end = std::min(end, base.count);
+        size_t hit = ::find_data_block(base.block_ids, base.index_flags, begin, segment_end, target);
+        if (hit != segment_end) {
+            return hit;
+        }
+        begin = segment_end;
+    }
+    if (begin >= end) {
+        return end;
+    }
+    
+    // 尾段
+    return base.count + ::find_data_block(block_ids.data(), index_flags.data(),
+                                          begin - base.count, end - base.count, target);
+}
+
+void TapeBlockStore::clear() {
+    base = BlockSegment();
+    block_ids.clear();
+    index_flags.clear();
+    sizes.clear();
+    offsets.clear();
+    payload.clear();
+    resident_offsets.clear();
+    total_bytes = 0;
+}
+
+// 磁带镜像文件格式（主机字节序）：
+//   TapeImageHeader
+//   元数据表：block_id[n](u64) | offset[n](u64) | size[n](u32) | index_flag[n](u8) | 填充到8字节对齐
+//             驻留表[resident_count]：(块位置 u64, 数据区偏移 u64)，仅合成模式使用
+//   数据区（从payload_offset开始，按页对齐）：实体化模式为全部块数据，合成模式为驻留块数据
+struct TapeImageHeader {
+    char magic[8];              // "FTAPEIMG"
+    uint32_t version;           // 格式版本
+    uint32_t payload_mode;      // PayloadMode
+    uint64_t block_count;       // 块数量
+    uint64_t block_size;        // 设备块大小
+    uint64_t total_bytes;       // 全部块的数据总字节数
+    uint64_t synthetic_seed;    // 合成模式种子
+    uint64_t resident_count;    // 驻留表条目数
+    uint64_t metadata_offset;   // 元数据表起始偏移
+    uint64_t payload_offset;    // 数据区起始偏移
+    uint64_t payload_bytes;     // 数据区字节数
+};
+
+const char TAPE_IMAGE_MAGIC[8] = {'F', 'T', 'A', 'P', 'E', 'I', 'M', 'G'};
+const uint32_t TAPE_IMAGE_VERSION = 1;
+const uint64_t TAPE_IMAGE_ALIGNMENT = 4096;
+
+// 只读文件映射
+class MappedFile {
+private:
+    const uint8_t* bytes = nullptr;
+    size_t length = 0;
+    
+public:
+    explicit MappedFile(const std::string& path) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("Cannot open tape image: " + path + ": " + std::strerror(errno));
+        }
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            throw std::runtime_error("Cannot stat tape image: " + path);
+        }
+        length = static_cast<size_t>(st.st_size);
+        if (length > 0) {
+            void* mapped = ::mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+            if (mapped == MAP_FAILED) {
+                ::close(fd);
+                throw std::runtime_error("Cannot map tape image: " + path + ": " + std::strerror(errno));
+            }
+            bytes = static_cast<const uint8_t*>(mapped);
+        }
+        ::close(fd);
+    }
+    
+    ~MappedFile() {
+        if (bytes) {
+            ::munmap(const_cast<uint8_t*>(bytes), length);
+        }
+    }
+    
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    
+    const uint8_t* data() const { return bytes; }
+    size_t size() const { return length; }
+};
+
+void TapeBlockStore::save_image(const std::string& path, size_t block_size) const {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw std::runtime_error("Cannot create tape image: " + path);
+    }
+    
+    size_t count = size();
+    
+    // 合成模式只保存驻留块的数据
+    std::vector<std::pair<uint64_t, uint64_t>> resident;
+    uint64_t payload_bytes = total_bytes;
+    if (mode == PayloadMode::Synthetic) {
+        std::vector<size_t> positions;
+        for (const auto& entry : resident_offsets) {
+            positions.push_back(entry.first);
+        }
+        std::sort(positions.begin(), positions.end());
+        payload_bytes = 0;
+        for (size_t pos : positions) {
+            resident.emplace_back(pos, payload_bytes);
+            payload_bytes += data_size(pos);
+        }
+    }
+    
+    TapeImageHeader header{};
+    std::memcpy(header.magic, TAPE_IMAGE_MAGIC, sizeof(header.magic));
+    header.version = TAPE_IMAGE_VERSION;
+    header.payload_mode = static_cast<uint32_t>(mode);
+    header.block_count = count;
+    header.block_size = block_size;
+    header.total_bytes = total_bytes;
+    header.synthetic_seed = synthetic_seed;
+    header.resident_count = resident.size();
+    header.metadata_offset = sizeof(TapeImageHeader);
+    uint64_t metadata_bytes = count * (sizeof(uint64_t) * 2 + sizeof(uint32_t) + sizeof(uint8_t));
+    metadata_bytes = (metadata_bytes + 7) / 8 * 8 + resident.size() * sizeof(uint64_t) * 2;
+    uint64_t metadata_end = header.metadata_offset + metadata_bytes;
+    header.payload_offset = (metadata_end + TAPE_IMAGE_ALIGNMENT - 1) / TAPE_IMAGE_ALIGNMENT * TAPE_IMAGE_ALIGNMENT;
+    header.payload_bytes = payload_bytes;
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    
+    // 按列写出：先基础段，再尾段
+    auto write_column = [&out](const void* base_data, const void* tail_data, size_t base_count,
+                               size_t tail_count, size_t element_size) {
+        out.write(static_cast<const char*>(base_data), base_count * element_size);
+        out.write(static_cast<const char*>(tail_data), tail_count * element_size);
+    };
+    size_t tail = block_ids.size();
+    write_column(base.block_ids, block_ids.data(), base.count, tail, sizeof(uint64_t));
+    write_column(base.offsets, offsets.data(), base.count, tail, sizeof(uint64_t));
+    write_column(base.sizes, sizes.data(), base.count, tail, sizeof(uint32_t));
+    write_column(base.index_flags, index_flags.data(), base.count, tail, sizeof(uint8_t));
+    
+    static const char zeros[TAPE_IMAGE_ALIGNMENT] = {};
+    size_t flags_end = count * (sizeof(uint64_t) * 2 + sizeof(uint32_t) + sizeof(uint8_t));
+    out.write(zeros, (8 - flags_end % 8) % 8);
+    for (const auto& [pos, offset] : resident) {
+        out.write(reinterpret_cast<const char*>(&pos), sizeof(pos));
+        out.write(reinterpret_cast<const char*>(&offset), sizeof(offset));
+    }
+    out.write(zeros, header.payload_offset - metadata_end);
+    
+    // 数据区
+    if (mode == PayloadMode::Materialized) {
+        out.write(reinterpret_cast<const char*>(base.payload), base.total_bytes);
+        out.write(reinterpret_cast<const char*>(payload.data(0)), payload.size());
+    } else {
+        for (const auto& entry : resident) {
+            out.write(reinterpret_cast<const char*>(data(entry.first)), data_size(entry.first));
+        }
+    }
+    
+    if (!out) {
+        throw std::runtime_error("Failed to write tape image: " + path);
+    }
+}
+
+void TapeBlockStore::share_from(const TapeBlockStore& source) {
+    if (source.base.count > 0 && !source.block_ids.empty()) {
+        throw std::logic_error("Cannot share a store with both mapped and appended blocks");
+    }
+    
+    clear();
+    mode = source.mode;
+    synthetic_seed = source.synthetic_seed;
+    resident_offsets = source.resident_offsets;
+    if (source.base.count > 0) {
+        base = source.base;
+    } else {
+        base.block_ids = source.block_ids.data();
+        base.index_flags = source.index_flags.data();
+        base.sizes = source.sizes.data();
+        base.offsets = source.offsets.data();
+        base.payload = source.payload.data(0);
+        base.count = source.block_ids.size();
+        base.total_bytes = source.total_bytes;
+    }
+    total_bytes = base.total_bytes;
+}
+
+size_t TapeBlockStore::open_image(const std::string& path) {
+    auto file = std::make_shared<MappedFile>(path);
+    const uint8_t* bytes = file->data();
+    
+    TapeImageHeader header;
+    if (file->size() < sizeof(header)) {
+        throw std::runtime_error("Invalid tape image (truncated header): " + path);
+    }
+    std::memcpy(&header, bytes, sizeof(header));
+    if (std::memcmp(header.magic, TAPE_IMAGE_MAGIC, sizeof(header.magic)) != 0) {
+        throw std::runtime_error("Invalid tape image (bad magic): " + path);
+    }
+    if (header.version != TAPE_IMAGE_VERSION) {
+        throw std::runtime_error("Unsupported tape image version: " + std::to_string(header.version));
+    }
+    
+    if (header.payload_mode != static_cast<uint32_t>(PayloadMode::Materialized) &&
+        header.payload_mode != static_cast<uint32_t>(PayloadMode::Synthetic)) {
+        throw std::runtime_error("Invalid tape image (unknown payload mode): " + path);
+    }
+    
+    // 各段大小先与文件长度比较再相乘相加，避免溢出
+    const uint64_t file_size = file->size();
+    const uint64_t row_bytes = sizeof(uint64_t) * 2 + sizeof(uint32_t) + sizeof(uint8_t);
+    uint64_t count = header.block_count;
+    if (header.metadata_offset % 8 != 0 || header.metadata_offset > file_size ||
+        count > (file_size - header.metadata_offset) / row_bytes ||
+        header.resident_count > file_size / (sizeof(uint64_t) * 2) ||
+        header.payload_offset > file_size || header.payload_bytes > file_size - header.payload_offset) {
+        throw std::runtime_error("Invalid tape image (truncated data): " + path);
+    }
+    uint64_t flags_end = header.metadata_offset + count * row_bytes;
+    uint64_t resident_begin = (flags_end + 7) / 8 * 8;
+    uint64_t resident_end = resident_begin + header.resident_count * sizeof(uint64_t) * 2;
+    if (resident_end > header.payload_offset) {
+        throw std::runtime_error("Invalid tape image (truncated data): " + path);
+    }
+    
+    // 偏移列必须是长度列的前缀和，实体化镜像的全部块数据都须落在数据区内
+    const uint8_t* metadata = bytes + header.metadata_offset;
+    const uint64_t* offsets_column = reinterpret_cast<const uint64_t*>(metadata + count * sizeof(uint64_t));
+    const uint32_t* sizes_column = reinterpret_cast<const uint32_t*>(metadata + count * sizeof(uint64_t) * 2);
+    uint64_t expected_offset = 0;
+    for (uint64_t i = 0; i < count; ++i) {
+        if (offsets_column[i] != expected_offset || sizes_column[i] > header.total_bytes - expected_offset) {
+            throw std::runtime_error("Invalid tape image (bad block extent " + std::to_string(i) + "): " + path);
+        }
+        expected_offset += sizes_column[i];
+    }
+    if (expected_offset != header.total_bytes) {
+        throw std::runtime_error("Invalid tape image (block sizes do not add up): " + path);
+    }
+    PayloadMode image_mode = static_cast<PayloadMode>(header.payload_mode);
+    if (image_mode == PayloadMode::Materialized && header.payload_bytes < header.total_bytes) {
+        throw std::runtime_error("Invalid tape image (payload shorter than blocks): " + path);
+    }
+    const uint64_t* resident_table = reinterpret_cast<const uint64_t*>(bytes + resident_begin);
+    for (uint64_t i = 0; i < header.resident_count; ++i) {
+        uint64_t pos = resident_table[i * 2];
+        uint64_t offset = resident_table[i * 2 + 1];
+        if (pos >= count || offset > header.payload_bytes || sizes_column[pos] > header.payload_bytes - offset) {
+            throw std::runtime_error("Invalid tape image (bad resident entry " + std::to_string(i) + "): " + path);
+        }
+    }
+    
+    clear();
+    mode = image_mode;
+    synthetic_seed = header.synthetic_seed;
+    
+    base.block_ids = reinterpret_cast<const uint64_t*>(metadata);
+    base.offsets = offsets_column;
+    base.sizes = sizes_column;
+    base.index_flags = metadata + count * (sizeof(uint64_t) * 2 + sizeof(uint32_t));
+    base.payload = bytes + header.payload_offset;
+    base.count = count;
+    base.total_bytes = header.total_bytes;
+    base.owner = file;
+    total_bytes = header.total_bytes;
+    
+    for (uint64_t i = 0; i < header.resident_count; ++i) {
+        resident_offsets[resident_table[i * 2]] = resident_table[i * 2 + 1];
+    }
+    
+    return header.block_size;
+}
+
+// 扫描内核实现
+size_t scan_data_block_scalar(const uint64_t* ids, const uint8_t* flags,
+                              size_t begin, size_t end, uint64_t target) {
+    for (size_t i = begin; i < end; ++i) {
+        if (ids[i] == target && !flags[i]) {
+            return i;
+        }
+    }
+    return end;
+}
+
+#if defined(TAPE_SCAN_X86)
+__attribute__((target("avx2")))
+size_t scan_data_block_avx2(const uint64_t* ids, const uint8_t* flags,
+                            size_t begin, size_t end, uint64_t target) {
+    const __m256i needle = _mm256_set1_epi64x(static_cast<long long>(target));
+    size_t i = begin;
+    for (; i + 8 <= end; i += 8) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ids + i));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ids + i + 4));
+        int mask = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(a, needle)))
+                 | (_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(b, needle))) << 4);
+        // ID命中后再检查索引块标志
+        while (mask) {
+            int lane = __builtin_ctz(static_cast<unsigned>(mask));
+            if (!flags[i + lane]) {
+                return i + lane;
+            }
+            mask &= mask - 1;
+        }
+    }
+    return scan_data_block_scalar(ids, flags, i, end, target);
+}
+
+__attribute__((target("avx512f")))
+size_t scan_data_block_avx512(const uint64_t* ids, const uint8_t* flags,
+                              size_t begin, size_t end, uint64_t target) {
+    const __m512i needle = _mm512_set1_epi64(static_cast<long long>(target));
+    size_t i = begin;
+    for (; i + 16 <= end; i += 16) {
+        __m512i a = _mm512_loadu_si512(ids + i);
+        __m512i b = _mm512_loadu_si512(ids + i + 8);
+        unsigned mask = _mm512_cmpeq_epi64_mask(a, needle)
+                      | (static_cast<unsigned>(_mm512_cmpeq_epi64_mask(b, needle)) << 8);
+        while (mask) {
+            unsigned lane = __builtin_ctz(mask);
+            if (!flags[i + lane]) {
+                return i + lane;
+            }
+            mask &= mask - 1;
+        }
+    }
+    return scan_data_block_scalar(ids, flags, i, end, target);
+}
+#elif defined(TAPE_SCAN_NEON)
+size_t scan_data_block_neon(const uint64_t* ids, const uint8_t* flags,
+                            size_t begin, size_t end, uint64_t target) {
+    const uint64x2_t needle = vdupq_n_u64(target);
+    size_t i = begin;
+    for (; i + 4 <= end; i += 4) {
+        uint64x2_t a = vceqq_u64(vld1q_u64(ids + i), needle);
+        uint64x2_t b = vceqq_u64(vld1q_u64(ids + i + 2), needle);
+        if (vmaxvq_u32(vreinterpretq_u32_u64(vorrq_u64(a, b))) != 0) {
+            size_t hit = scan_data_block_scalar(ids, flags, i, i + 4, target);
+            if (hit != i + 4) {
+                return hit;
+            }
+        }
+    }
+    return scan_data_block_scalar(ids, flags, i, end, target);
+}
+#endif
+
+BlockScanKernel select_scan_kernel() {
+#if defined(TAPE_SCAN_X86)
+    if (__builtin_cpu_supports("avx512f")) {
+        return scan_data_block_avx512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return scan_data_block_avx2;
+    }
+#elif defined(TAPE_SCAN_NEON)
+    return scan_data_block_neon;
+#endif
+    return scan_data_block_scalar;
+}
+
+size_t find_data_block(const uint64_t* ids, const uint8_t* flags,
+                       size_t begin, size_t end, uint64_t target) {
+    static const BlockScanKernel kernel = select_scan_kernel();
+    return kernel(ids, flags, begin, end, target);
+}
+
+const char* scan_kernel_name() {
+    BlockScanKernel kernel = select_scan_kernel();
+#if defined(TAPE_SCAN_X86)
+    if (kernel == scan_data_block_avx512) return "avx512";
+    if (kernel == scan_data_block_avx2) return "avx2";
+#elif defined(TAPE_SCAN_NEON)
+    if (kernel == scan_data_block_neon) return "neon";
+#endif
+    return "scalar";
+}
+
+// 磁带几何实现
+TapeCoordinate TapeGeometry::locate(size_t position) const {
+    if (blocks_per_wrap == 0) {
+        return {position, 0, position};
+    }
+    size_t wrap = position / blocks_per_wrap;
+    size_t offset = position % blocks_per_wrap;
+    return {position, wrap, (wrap % 2 == 0) ? offset : blocks_per_wrap - 1 - offset};
+}
+
+size_t TapeGeometry::align_to_wrap(size_t position) const {
+    if (blocks_per_wrap == 0) {
+        return position;
+    }
+    return (position + blocks_per_wrap - 1) / blocks_per_wrap * blocks_per_wrap;
+}
+
+// 寻道模型实现
+double LinearSeekModel::locate_time(const TapeCoordinate& from, const TapeCoordinate& to) const {
+    size_t distance = (to.position > from.position) ? to.position - from.position : from.position - to.position;
+    return distance * time_per_block;
+}
+
+double PiecewiseSeekModel::travel_time(size_t distance) const {
+    size_t locate_blocks = std::min(distance, params.locate_threshold);
+    return locate_blocks * params.locate_time_per_block
+         + (distance - locate_blocks) * params.wind_time_per_block;
+}
+
+double PiecewiseSeekModel::locate_time(const TapeCoordinate& from, const TapeCoordinate& to) const {
+    if (from.position == to.position) {
+        return 0.0;
+    }
+    bool backward = to.position < from.position;
+    double time = params.ramp_time + travel_time(backward ? from.position - to.position : to.position - from.position);
+    if (backward) {
+        time += params.reversal_time;
+    }
+    return time;
+}
+
+SerpentineSeekModel::SerpentineSeekModel(double wrap_switch_time, const PiecewiseSeekParams& params)
+    : PiecewiseSeekModel(params), wrap_switch_time(wrap_switch_time) {}
+
+double SerpentineSeekModel::pass_time(const TapeCoordinate& from, const TapeCoordinate& to) const {
+    // 每跨过一个磁道末尾需要停带、换道、反向
+    size_t turnarounds = to.wrap - from.wrap;
+    return (to.position - from.position) * params.stream_time_per_block
+         + turnarounds * (params.ramp_time + wrap_switch_time + params.reversal_time);
+}
+
+double SerpentineSeekModel::locate_time(const TapeCoordinate& from, const TapeCoordinate& to) const {
+    if (from.position == to.position) {
+        return 0.0;
+    }
+    
+    double switch_time = (from.wrap != to.wrap) ? wrap_switch_time : 0.0;
+    if (from.longitudinal == to.longitudinal) {
+        // 只换道；目标磁道方向相反时还需反向
+        return params.ramp_time + switch_time + (from.forward() != to.forward() ? params.reversal_time : 0.0);
+    }
+    
+    // 相对当前磁道方向反向移动、或到达时方向与目标磁道相反，各需一次反向
+    bool move_forward = to.longitudinal > from.longitudinal;
+    size_t reversals = (move_forward != from.forward()) + (move_forward != to.forward());
+    double travel = travel_time(move_forward ? to.longitudinal - from.longitudinal
+                                             : from.longitudinal - to.longitudinal);
+    return params.ramp_time + std::max(travel, switch_time) + reversals * params.reversal_time;
+}
+
+std::unique_ptr<SeekModel> SeekModelFactory::create_seek_model(const std::string& type, double seek_time_per_block) {
+    if (type == "linear") {
+        return std::make_unique<LinearSeekModel>(seek_time_per_block);
+    } else if (type == "piecewise") {
+        return std::make_unique<PiecewiseSeekModel>();
+    } else if (type == "serpentine") {
+        return std::make_unique<SerpentineSeekModel>();
+    } else {
+        throw std::invalid_argument("Unknown seek model: " + type);
+    }
+}
+
+// 块缓存实现
+bool LruBlockCache::lookup(uint64_t key) {
+    auto it = entries.find(key);
+    if (it == entries.end()) {
+        return false;
+    }
+    order.splice(order.begin(), order, it->second);
+    return true;
+}
+
+void LruBlockCache::insert(uint64_t key, size_t bytes) {
+    if (bytes > capacity || entries.count(key) != 0) {
+        return;
+    }
+    while (used + bytes > capacity) {
+        used -= order.back().second;
+        entries.erase(order.back().first);
+        order.pop_back();
+    }
+    order.emplace_front(key, bytes);
+    entries[key] = order.begin();
+    used += bytes;
+}
+
+void LruBlockCache::clear() {
+    order.clear();
+    entries.clear();
+    used = 0;
+}
+
+bool ArcBlockCache::contains(uint64_t key) const {
+    auto it = entries.find(key);
+    return it != entries.end() && (it->second.list == T1 || it->second.list == T2);
+}
+
+void ArcBlockCache::move_to(uint64_t key, Which list) {
+    Entry& entry = entries.at(key);
+    size_t size = entry.it->second;
+    bytes[entry.list] -= size;
+    bytes[list] += size;
+    lists[list].splice(lists[list].begin(), lists[entry.list], entry.it);
+    entry.list = list;
+}
+
+void ArcBlockCache::drop_lru(Which list) {
+    auto [key, size] = lists[list].back();
+    bytes[list] -= size;
+    lists[list].pop_back();
+    entries.erase(key);
+}
+
+void ArcBlockCache::replace(size_t needed, bool in_b2) {
+    while (bytes[T1] + bytes[T2] + needed > capacity) {
+        bool from_t1 = !lists[T1].empty() &&
+                       (bytes[T1] > target || (in_b2 && bytes[T1] >= target) || lists[T2].empty());
+        Which from = from_t1 ? T1 : T2;
+        move_to(lists[from].back().first, from_t1 ? B1 : B2);
+    }
+}
+
+bool ArcBlockCache::lookup(uint64_t key) {
+    auto it = entries.find(key);
+    if (it == entries.end() || (it->second.list != T1 && it->second.list != T2)) {
+        return false;
+    }
+    move_to(key, T2);
+    return true;
+}
+
+void ArcBlockCache::insert(uint64_t key, size_t size) {
+    if (size > capacity || contains(key)) {
+        return;
+    }
+    
+    auto it = entries.find(key);
+    if (it != entries.end()) {
+        // 幽灵命中：B1命中说明T1偏小，B2命中说明T2偏小
+        bool in_b1 = it->second.list == B1;
+        double ratio = in_b1 ? static_cast<double>(bytes[B2]) / std::max<size_t>(bytes[B1], 1)
+                             : static_cast<double>(bytes[B1]) / std::max<size_t>(bytes[B2], 1);
+        double delta = std::max(1.0, ratio) * size;
+        target = in_b1 ? std::min<double>(capacity, target + delta) : std::max(0.0, target - delta);
+        
+        // 幽灵项记录的是旧长度，先移除再按新长度插入T2
+        bytes[it->second.list] -= it->second.it->second;
+        lists[it->second.list].erase(it->second.it);
+        entries.erase(it);
+        replace(size, !in_b1);
+        lists[T2].emplace_front(key, size);
+        entries[key] = {T2, lists[T2].begin()};
+        bytes[T2] += size;
+        while (bytes[T1] + bytes[T2] + bytes[B1] + bytes[B2] > 2 * capacity && !lists[B2].empty()) {
+            drop_lru(B2);
+        }
+        return;
+    }
+    
+    // 新块：控制幽灵表规模（T1+B1不超过容量，总量不超过两倍容量）
+    while (bytes[T1] + bytes[B1] + size > capacity && !lists[B1].empty()) {
+        drop_lru(B1);
+    }
+    while (bytes[T1] + bytes[T2] + bytes[B1] + bytes[B2] + size > 2 * capacity && !lists[B2].empty()) {
+        drop_lru(B2);
+    }
+    replace(size, false);
+    lists[T1].emplace_front(key, size);
+    entries[key] = {T1, lists[T1].begin()};
+    bytes[T1] += size;
+}
+
+void ArcBlockCache::clear() {
+    for (size_t i = 0; i < 4; ++i) {
+        lists[i].clear();
+        bytes[i] = 0;
+    }
+    entries.clear();
+    target = 0.0;
+}
+
+std::unique_ptr<BlockCache> BlockCacheFactory::create_cache(const std::string& policy, size_t capacity_bytes) {
+    if (policy == "none") {
+        return nullptr;
+    } else if (policy == "lru") {
+        return std::make_unique<LruBlockCache>(capacity_bytes);
+    } else if (policy == "arc") {
+        return std::make_unique<ArcBlockCache>(capacity_bytes);
+    } else {
+        throw std::invalid_argument("Unknown cache policy: " + policy);
+    }
+}
+
+// TapeDevice 实现
+TapeDevice::TapeDevice(size_t block_size, double read_speed, double write_speed, double seek_time)
+    : block_size(block_size), read_speed(read_speed), write_speed(write_speed),
+      seek_time_per_block(seek_time), current_position(0),
+      seek_model(std::make_unique<LinearSeekModel>(seek_time)) {}  // 初始化顺序与成员声明顺序一致
+
+void TapeDevice::set_seek_model(std::unique_ptr<SeekModel> model) {
+    seek_model = model ? std::move(model) : std::make_unique<LinearSeekModel>(seek_time_per_block);
+}
+
+double TapeDevice::write_block(const TapeBlock& block) {
+    blocks.append(block.block_id, block.data.data(), block.data.size(), block.is_index_block);
+    note_write(block.data.size());
+    double time = block.data.size() / write_speed;
+    return time + notify_append();
+}
+
+double TapeDevice::write_synthetic_block(uint64_t block_id, size_t size) {
+    blocks.append_synthetic(block_id, size, false);
+    note_write(size);
+    double time = size / write_speed;
+    return time + notify_append();
+}
+
+double TapeDevice::notify_append() {
+    if (append_observers.empty()) {
+        return 0.0;
+    }
+    // 观察者可能写入新块（重入write_block），按下标通知刚写入的块
+    size_t position = blocks.size() - 1;
+    double time = 0.0;
+    for (size_t i = 0; i < append_observers.size(); ++i) {
+        time += append_observers[i]->on_append(*this, blocks.view(position), position);
+    }
+    return time;
+}
+
+void TapeDevice::remove_append_observer(BlockAppendObserver* observer) {
+    append_observers.erase(std::remove(append_observers.begin(), append_observers.end(), observer),
+                           append_observers.end());
+}
+
+std::pair<uint8_t*, double> TapeDevice::emplace_block(uint64_t block_id, size_t size, bool is_index) {
+    uint8_t* data = blocks.emplace(block_id, size, is_index);
+    note_write(size);
+    double time = size / write_speed;
+    return {data, time};
+}
+
+std::pair<size_t, double> TapeDevice::write_index_partition_block(const TapeBlock& block) {
+    if (index_partition.size() >= index_partition_capacity) {
+        throw std::length_error("Index partition full");
+    }
+    size_t position = index_partition.size();
+    index_partition.append(block.block_id, block.data.data(), block.data.size(), block.is_index_block);
+    note_write(block.data.size());
+    return {position, block.data.size() / write_speed};
+}
+
+std::pair<size_t, double> TapeDevice::write_interleaved_block(size_t anchor, const TapeBlock& block) {
+    if (anchor >= blocks.size()) {
+        throw std::out_of_range("Interleave anchor out of range");
+    }
+    if (!interleaved_anchors.empty() && anchor < interleaved_anchors.back()) {
+        throw std::invalid_argument("Interleaved blocks must be written in tape order");
+    }
+    size_t position = interleaved_blocks.size();
+    interleaved_blocks.append(block.block_id, block.data.data(), block.data.size(), block.is_index_block);
+    interleaved_anchors.push_back(anchor);
+    note_write(block.data.size());
+    return {position, block.data.size() / write_speed};
+}
+
+void TapeDevice::format_index_partition(size_t capacity) {
+    clear_index_blocks();
+    index_partition_capacity = capacity;
+}
+
+void TapeDevice::clear_index_blocks() {
+    if (current_region != TapeRegion::Data) {
+        current_position = get_data_position();
+        current_region = TapeRegion::Data;
+    }
+    head_region = current_region;
+    head_position = current_position;
+    if (cache) {
+        cache->clear();
+    }
+    index_partition.clear();
+    interleaved_blocks.clear();
+    interleaved_anchors.clear();
+}
+
+const TapeBlockStore& TapeDevice::region_store(TapeRegion region) const {
+    switch (region) {
+        case TapeRegion::IndexPartition: return index_partition;
+        case TapeRegion::Interleaved: return interleaved_blocks;
+        case TapeRegion::Data: break;
+    }
+    return blocks;
+}
+
+size_t TapeDevice::physical_position(TapeRegion region, size_t position) const {
+    switch (region) {
+        case TapeRegion::IndexPartition:
+            return position;
+        case TapeRegion::Interleaved:
+            // 前面的position个穿插块都在它之前
+            return geometry.align_to_wrap(index_partition_capacity) + interleaved_anchors[position] + 1 + position;
+        case TapeRegion::Data:
+            break;
+    }
+    // 锚点小于position的穿插块都在它之前
+    size_t interleaved_before = std::lower_bound(interleaved_anchors.begin(), interleaved_anchors.end(), position)
+                                - interleaved_anchors.begin();
+    return geometry.align_to_wrap(index_partition_capacity) + position + interleaved_before;
+}
+
+size_t TapeDevice::get_data_position() const {
+    switch (current_region) {
+        case TapeRegion::IndexPartition:
+            return 0;
+        case TapeRegion::Interleaved:
+            return std::min(interleaved_anchors[current_position] + 1, blocks.size() - 1);
+        case TapeRegion::Data:
+            break;
+    }
+    return current_position;
+}
+
+std::pair<TapeBlock, double> TapeDevice::read_current_block() {
+    auto [view, time] = view_current_block();
+    std::vector<uint8_t> data;
+    region_store(current_region).copy_payload(current_position, data);
+    TapeBlock block(view.block_id, std::move(data), view.is_index_block);
+    return {std::move(block), time};
+}
+
+std::pair<TapeBlockView, double> TapeDevice::view_current_block() {
+    if (current_position >= region_store(current_region).size()) {
+        throw std::out_of_range("Position out of range");
+    }
+    return view_current_block_as<SeekModel, BlockCache>();
+}
+
+template <typename Model, typename Cache>
+std::pair<TapeBlockView, double> TapeDevice::view_current_block_as() {
+    const TapeBlockStore& store = region_store(current_region);
+    TapeBlockView view = store.view(current_position);
+    io_stats.blocks_read++;
+    io_stats.bytes_read += view.size;
+    if constexpr (std::is_same_v<Cache, NoBlockCache>) {
+        return {view, view.size / read_speed};
+    } else {
+        if (!cache) {
+            return {view, view.size / read_speed};
+        }
+        
+        uint64_t key = cache_key(current_region, current_position);
+        if (BlockCacheOps<Cache>::lookup(*cache, key)) {
+            cache_stats.hits++;
+            return {view, view.size / cache_config.buffer_bandwidth};
+        }
+        
+        // 未命中：磁带移到该块读取，并继续预读其后的块
+        cache_stats.misses++;
+        double time = move_tape_to_current_as<Model>() + view.size / read_speed;
+        BlockCacheOps<Cache>::insert(*cache, key, view.size);
+        
+        size_t last = std::min(store.size() - 1, current_position + cache_config.read_ahead_blocks);
+        if (last > current_position) {
+            for (size_t p = current_position + 1; p <= last; ++p) {
+                if (!BlockCacheOps<Cache>::contains(*cache, cache_key(current_region, p))) {
+                    BlockCacheOps<Cache>::insert(*cache, cache_key(current_region, p), store.data_size(p));
+                    cache_stats.read_ahead_blocks++;
+                }
+            }
+            time += SeekModelOps<Model>::pass_time(*seek_model, coordinate_of(current_region, current_position),
+                                                   coordinate_of(current_region, last));
+            time += (store.bytes_before(last + 1) - store.bytes_before(current_position + 1)) / read_speed;
+            head_position = last;
+            note_motion(1);
+        }
+        return {view, time};
+    }
+}
+
+template <typename Model>
+double TapeDevice::move_tape_to_current_as() {
+    double time = SeekModelOps<Model>::seek_time(*seek_model, coordinate_of(head_region, head_position),
+                                                 coordinate_of(current_region, current_position));
+    size_t from = physical_position(head_region, head_position);
+    size_t to = physical_position(current_region, current_position);
+    if (from != to) {
+        io_stats.seeks++;
+        io_stats.seek_distance += (from > to) ? from - to : to - from;
+        note_motion(to > from ? 1 : -1);
+    }
+    head_region = current_region;
+    head_position = current_position;
+    return time;
+}
+
+void TapeDevice::note_motion(int direction) {
+    if (motion_direction != 0 && motion_direction != direction) {
+        io_stats.direction_reversals++;
+    }
+    motion_direction = direction;
+}
+
+double TapeDevice::seek_to_block(size_t block_index) {
+    return seek_to(TapeRegion::Data, block_index);
+}
+
+double TapeDevice::seek_to(TapeRegion region, size_t position) {
+    if (position >= region_store(region).size()) {
+        throw std::out_of_range("Block index out of range");
+    }
+    return seek_to_as<SeekModel, BlockCache>(region, position);
+}
+
+template <typename Model, typename Cache>
+double TapeDevice::seek_to_as(TapeRegion region, size_t position) {
+    current_region = region;
+    current_position = position;
+    
+    // 目标块在缓冲区中时磁带不动，读取时直接从缓冲区返回
+    if constexpr (!std::is_same_v<Cache, NoBlockCache>) {
+        if (cache && BlockCacheOps<Cache>::contains(*cache, cache_key(region, position))) {
+            return 0.0;
+        }
+    }
+    return move_tape_to_current_as<Model>();
+}
+
+void TapeDevice::set_cache(const DeviceCacheConfig& config) {
+    cache_config = config;
+    cache = BlockCacheFactory::create_cache(config.policy, config.capacity_bytes);
+    cache_stats = DeviceCacheStats();
+    reset_io_stats();
+}
+
+double TapeDevice::move_forward(size_t n) {
+    size_t region_size = region_store(current_region).size();
+    size_t new_pos = current_position + n;
+    if (new_pos >= region_size) {
+        new_pos = region_size - 1;
+    }
+    
+    return seek_to(current_region, new_pos);
+}
+
+double TapeDevice::move_backward(size_t n) {
+    size_t new_pos = (current_position >= n) ? current_position - n : 0;
+    return seek_to(current_region, new_pos);
+}
+
+double TapeDevice::scan_blocks(size_t count) {
+    if (count == 0) {
+        return 0.0;
+    }
+    
+    double time = 0.0;
+    if (current_region != TapeRegion::Data && blocks.size() > 0) {
+        time += seek_to_block(get_data_position());
+    }
+    time += move_tape_to_current();
+    
+    size_t block_count = blocks.size();
+    if (current_position >= block_count) {
+        throw std::out_of_range("Position out of range");
+    }
+    if (count > block_count) {
+        throw std::out_of_range("Scan length out of range");
+    }
+    
+    // 第一段：[current_position, block_count)
+    size_t first = current_position;
+    size_t tail = std::min(count, block_count - first);
+    uint64_t bytes = blocks.bytes_before(first + tail) - blocks.bytes_before(first);
+    size_t last = first + tail - 1;
+    time += seek_model->pass_time(get_coordinate(first), get_coordinate(last));
+    if (last > first) {
+        note_motion(1);
+    }
+    
+    // 第二段：回绕到0后继续读取，回绕本身是一次从末块到首块的寻道
+    if (count > tail) {
+        size_t head = count - tail;
+        TapeCoordinate origin = get_coordinate(0);
+        bytes += blocks.bytes_before(head);
+        time += seek_model->seek_time(get_coordinate(block_count - 1), origin);
+        time += seek_model->pass_time(origin, get_coordinate(head - 1));
+        last = head - 1;
+        io_stats.seeks++;
+        io_stats.seek_distance += physical_position(TapeRegion::Data, block_count - 1) -
+                                  physical_position(TapeRegion::Data, 0);
+        note_motion(-1);
+        if (head > 1) {
+            note_motion(1);
+        }
+    }
+    io_stats.blocks_read += count;
+    io_stats.bytes_read += bytes;
+    
+    current_position = last;
+    head_region = current_region;
+    head_position = current_position;
+    return time + bytes / read_speed;
+}
+
+size_t TapeDevice::get_current_position() const {
+    return current_position;
+}
+
+size_t TapeDevice::get_block_count() const {
+    return blocks.size();
+}
+
+TapeBlock TapeDevice::get_block(size_t index) const {
+    TapeBlockView view = view_block(index);
+    return TapeBlock(view.block_id, load_payload(index), view.is_index_block);
+}
+
+std::vector<uint8_t> TapeDevice::load_payload(size_t index) const {
+    if (index >= blocks.size()) {
+        throw std::out_of_range("Block index out of range");
+    }
+    std::vector<uint8_t> data;
+    blocks.copy_payload(index, data);
+    return data;
+}
+
+TapeBlockView TapeDevice::view_block(size_t index) const {
+    if (index >= blocks.size()) {
+        throw std::out_of_range("Block index out of range");
+    }
+    return blocks.view(index);
+}
+
+void TapeDevice::reset() {
+    clear_index_blocks();
+    blocks.clear();
+    current_position = 0;
+    head_position = 0;
+}
+
+void TapeDevice::save_image(const std::string& path) const {
+    blocks.save_image(path, block_size);
+}
+
+void TapeDevice::open_image(const std::string& path) {
+    clear_index_blocks();
+    block_size = blocks.open_image(path);
+    current_position = 0;
+    head_position = 0;
+}
+
+// 索引容器实现
+// 按键排序并去重，重复键保留最后一次出现的值
+void sort_unique_entries(std::vector<std::pair<uint64_t, uint64_t>>& entries) {
+    std::stable_sort(entries.begin(), entries.end(),
+                     [](const auto& a, const auto& b) { return a.first < b.first; });
+    size_t out = 0;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        if (i + 1 < entries.size() && entries[i + 1].first == entries[i].first) {
+            continue;
+        }
+        entries[out++] = entries[i];
+    }
+    entries.resize(out);
+}
+
+void HashIndexContainer::build(std::vector<std::pair<uint64_t, uint64_t>> entries) {
+    entries_map.clear();
+    entries_map.reserve(entries.size());
+    for (const auto& [key, value] : entries) {
+        entries_map[key] = value;
+    }
+}
+
+bool HashIndexContainer::find(uint64_t key, uint64_t& value) const {
+    auto it = entries_map.find(key);
+    if (it == entries_map.end()) {
+        return false;
+    }
+    value = it->second;
+    return true;
+}
+
+size_t HashIndexContainer::memory_bytes() const {
+    // 节点：键值对 + next指针 + 缓存的哈希值；桶数组：每桶一个指针
+    size_t node_bytes = sizeof(std::pair<const uint64_t, uint64_t>) + 2 * sizeof(void*);
+    return entries_map.size() * node_bytes + entries_map.bucket_count() * sizeof(void*);
+}
+
+void SortedArrayIndexContainer::build_static(const std::vector<std::pair<uint64_t, uint64_t>>& sorted) {
+    keys.resize(sorted.size());
+    values.resize(sorted.size());
+    for (size_t i = 0; i < sorted.size(); ++i) {
+        keys[i] = sorted[i].first;
+        values[i] = sorted[i].second;
+    }
+}
+
+bool SortedArrayIndexContainer::find_static(uint64_t key, uint64_t& value) const {
+    if (keys.empty()) {
+        return false;
+    }
+    
+    // 无分支二分：保持答案（最后一个<=key的元素）在[first, first + len)内
+    const uint64_t* first = keys.data();
+    size_t len = keys.size();
+    while (len > 1) {
+        size_t half = len / 2;
+        first = (first[half] <= key) ? first + half : first;
+        len -= half;
+    }
+    
+    if (*first != key) {
+        return false;
+    }
+    value = values[first - keys.data()];
+    return true;
+}
+
+void SortedArrayIndexContainer::export_static(std::vector<std::pair<uint64_t, uint64_t>>& out) const {
+    for (size_t i = 0; i < keys.size(); ++i) {
+        out.emplace_back(keys[i], values[i]);
+    }
+}
+
+void SortedArrayIndexContainer::insert(uint64_t key, uint64_t value) {
+    if (!has_pending_inserts() && (keys.empty() || keys.back() < key)) {
+        keys.push_back(key);
+        values.push_back(value);
+        return;
+    }
+    StaticLayoutIndexContainer::insert(key, value);
+}
+
+size_t SortedArrayIndexContainer::static_memory_bytes() const {
+    return (keys.capacity() + values.capacity()) * sizeof(uint64_t);
+}
+
+void StaticLayoutIndexContainer::build(std::vector<std::pair<uint64_t, uint64_t>> entries) {
+    delta.clear();
+    delta_new_keys = 0;
+    sort_unique_entries(entries);
+    build_static(entries);
+}
+
+void StaticLayoutIndexContainer::insert(uint64_t key, uint64_t value) {
+    uint64_t existing = 0;
+    if (delta.insert_or_assign(key, value).second && !find_static(key, existing)) {
+        ++delta_new_keys;
+    }
+    if (delta.size() > std::max<size_t>(64, static_size() / 8)) {
+        merge();
+    }
+}
+
+void StaticLayoutIndexContainer::merge() {
+    // 静态部分已有序；增量表排序后归并，相同键取增量表的值
+    std::vector<std::pair<uint64_t, uint64_t>> current;
+    current.reserve(static_size());
+    export_static(current);
+    std::vector<std::pair<uint64_t, uint64_t>> added(delta.begin(), delta.end());
+    std::sort(added.begin(), added.end());
+    
+    std::vector<std::pair<uint64_t, uint64_t>> merged;
+    merged.reserve(current.size() + added.size());
+    size_t i = 0, j = 0;
+    while (i < current.size() || j < added.size()) {
+        if (j == added.size() || (i < current.size() && current[i].first < added[j].first)) {
+            merged.push_back(current[i++]);
+        } else {
+            if (i < current.size() && current[i].first == added[j].first) {
+                ++i;
+            }
+            merged.push_back(added[j++]);
+        }
+    }
+    
+    delta.clear();
+    delta_new_keys = 0;
+    build_static(merged);
+}
+
+bool StaticLayoutIndexContainer::find(uint64_t key, uint64_t& value) const {
+    return find_as<StaticLayoutIndexContainer>(key, value);
+}
+
+size_t StaticLayoutIndexContainer::memory_bytes() const {
+    // 增量表按哈希表节点与桶数组估算（同HashIndexContainer）
+    size_t node_bytes = sizeof(std::pair<const uint64_t, uint64_t>) + 2 * sizeof(void*);
+    return static_memory_bytes() + delta.size() * node_bytes + delta.bucket_count() * sizeof(void*);
+}
+
+size_t EytzingerIndexContainer::fill(const std::vector<std::pair<uint64_t, uint64_t>>& sorted,
+                                     size_t next, size_t k) {
+    // 中序遍历隐式树，依次放入有序元素
+    if (k < keys.size()) {
+        next = fill(sorted, next, 2 * k);
+        keys[k] = sorted[next].first;
+        values[k] = sorted[next].second;
+        next = fill(sorted, next + 1, 2 * k + 1);
+    }
+    return next;
+}
+
+void EytzingerIndexContainer::collect(std::vector<std::pair<uint64_t, uint64_t>>& out, size_t k) const {
+    if (k < keys.size()) {
+        collect(out, 2 * k);
+        out.emplace_back(keys[k], values[k]);
+        collect(out, 2 * k + 1);
+    }
+}
+
+void EytzingerIndexContainer::build_static(const std::vector<std::pair<uint64_t, uint64_t>>& sorted) {
+    keys.assign(sorted.size() + 1, 0);
+    values.assign(sorted.size() + 1, 0);
+    fill(sorted, 0, 1);
+}
+
+bool EytzingerIndexContainer::find_static(uint64_t key, uint64_t& value) const {
+    size_t n = static_size();
+    if (n == 0) {
+        return false;
+    }
+    
+    const uint64_t* tree = keys.data();
+    size_t k = 1;
+    while (k <= n) {
+        // 预取4层之后的节点（16个键恰好覆盖两条缓存行）
+        __builtin_prefetch(tree + std::min(k * 16, n));
+        k = 2 * k + (tree[k] < key);
+    }
+    // 去掉末尾向右转的路径，得到第一个>=key的节点
+    k >>= __builtin_ffsll(static_cast<long long>(~k));
+    
+    if (k == 0 || tree[k] != key) {
+        return false;
+    }
+    value = values[k];
+    return true;
+}
+
+size_t EytzingerIndexContainer::static_memory_bytes() const {
+    return (keys.capacity() + values.capacity()) * sizeof(uint64_t);
+}
+
+size_t BTreeIndexContainer::fill(const std::vector<std::pair<uint64_t, uint64_t>>& sorted,
+                                 size_t next, size_t node) {
+    // 中序遍历：子树0、键0、子树1、键1 … 子树8
+    if (node >= node_count) {
+        return next;
+    }
+    for (size_t i = 0; i < NODE_KEYS; ++i) {
+        next = fill(sorted, next, node * (NODE_KEYS + 1) + i + 1);
+        size_t slot = node * NODE_KEYS + i;
+        if (next < sorted.size()) {
+            keys[slot] = sorted[next].first;
+            values[slot] = sorted[next].second;
+            ++next;
+        } else {
+            keys[slot] = std::numeric_limits<uint64_t>::max();
+        }
+    }
+    return fill(sorted, next, node * (NODE_KEYS + 1) + NODE_KEYS + 1);
+}
+
+void BTreeIndexContainer::collect(std::vector<std::pair<uint64_t, uint64_t>>& out, size_t node) const {
+    // 与fill相同的中序遍历，跳过填充键
+    if (node >= node_count) {
+        return;
+    }
+    for (size_t i = 0; i < NODE_KEYS; ++i) {
+        collect(out, node * (NODE_KEYS + 1) + i + 1);
+        size_t slot = node * NODE_KEYS + i;
+        if (keys[slot] != std::numeric_limits<uint64_t>::max()) {
+            out.emplace_back(keys[slot], values[slot]);
+        }
+    }
+    collect(out, node * (NODE_KEYS + 1) + NODE_KEYS + 1);
+}
+
+void BTreeIndexContainer::build_static(const std::vector<std::pair<uint64_t, uint64_t>>& sorted) {
+    entry_count = sorted.size();
+    node_count = (entry_count + NODE_KEYS - 1) / NODE_KEYS;
+    keys.assign(node_count * NODE_KEYS, std::numeric_limits<uint64_t>::max());
+    values.assign(node_count * NODE_KEYS, 0);
+    fill(sorted, 0, 0);
+}
+
+bool BTreeIndexContainer::find_static(uint64_t key, uint64_t& value) const {
+    size_t candidate = keys.size();
+    size_t node = 0;
+    while (node < node_count) {
+        // 节点内计数小于key的键数（无分支，可被向量化）
+        const uint64_t* node_keys = keys.data() + node * NODE_KEYS;
+        size_t rank = 0;
+        for (size_t i = 0; i < NODE_KEYS; ++i) {
+            rank += (node_keys[i] < key);
+        }
+        if (rank < NODE_KEYS) {
+            candidate = node * NODE_KEYS + rank;
+        }
+        node = node * (NODE_KEYS + 1) + rank + 1;
+    }
+    
+    if (candidate == keys.size() || keys[candidate] != key) {
+        return false;
+    }
+    value = values[candidate];
+    return true;
+}
+
+size_t BTreeIndexContainer::static_memory_bytes() const {
+    return (keys.capacity() + values.capacity()) * sizeof(uint64_t);
+}
+
+std::unique_ptr<IndexContainer> IndexContainerFactory::create_container(const std::string& type) {
+    if (type == "hash") {
+        return std::make_unique<HashIndexContainer>();
+    } else if (type == "sorted") {
+        return std::make_unique<SortedArrayIndexContainer>();
+    } else if (type == "eytzinger") {
+        return std::make_unique<EytzingerIndexContainer>();
+    } else if (type == "btree") {
+        return std::make_unique<BTreeIndexContainer>();
+    } else {
+        throw std::invalid_argument("Unknown index container: " + type);
+    }
+}
+
+// 成员过滤器实现
+// 64位键混合（splitmix64终结函数），过滤器的各个哈希值都由它导出
+static uint64_t filter_hash(uint64_t key) {
+    key += 0x9E3779B97F4A7C15ULL;
+    key = (key ^ (key >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    key = (key ^ (key >> 27)) * 0x94D049BB133111EBULL;
+    return key ^ (key >> 31);
+}
+
+// 最优哈希个数k = bits_per_key * ln2，至少为1
+static size_t bloom_hash_count(size_t bits_per_key) {
+    return std::max<size_t>(1, static_cast<size_t>(std::lround(bits_per_key * 0.69314718)));
+}
+
+BloomFilter::BloomFilter(size_t bits_per_key)
+    : bits_per_key(std::max<size_t>(1, bits_per_key)), hash_count(bloom_hash_count(this->bits_per_key)) {}
+
+void BloomFilter::add_layer(size_t capacity) {
+    Layer layer;
+    layer.bit_count = std::max<size_t>(64, capacity * bits_per_key);
+    layer.capacity = layer.bit_count / bits_per_key;
+    layer.bits.assign((layer.bit_count + 63) / 64, 0);
+    layers.push_back(std::move(layer));
+}
+
+void BloomFilter::build(const std::vector<uint64_t>& keys) {
+    layers.clear();
+    key_count = 0;
+    add_layer(keys.size());
+    for (uint64_t key : keys) {
+        insert(key);
+    }
+}
+
+void BloomFilter::insert(uint64_t key) {
+    if (layers.empty()) {
+        build({});
+    }
+    if (layers.back().key_count >= layers.back().capacity) {
+        add_layer(layers.back().capacity * 2);
+    }
+    Layer& layer = layers.back();
+    uint64_t h = filter_hash(key);
+    uint64_t h1 = h & 0xFFFFFFFFULL;
+    uint64_t h2 = (h >> 32) | 1;
+    for (size_t i = 0; i < hash_count; ++i) {
+        uint64_t bit = (h1 + i * h2) % layer.bit_count;
+        layer.bits[bit / 64] |= 1ULL << (bit % 64);
+    }
+    ++layer.key_count;
+    ++key_count;
+}
+
+bool BloomFilter::may_contain(uint64_t key) const {
+    uint64_t h = filter_hash(key);
+    uint64_t h1 = h & 0xFFFFFFFFULL;
+    uint64_t h2 = (h >> 32) | 1;
+    for (const Layer& layer : layers) {
+        bool present = true;
+        for (size_t i = 0; i < hash_count && present; ++i) {
+            uint64_t bit = (h1 + i * h2) % layer.bit_count;
+            present = (layer.bits[bit / 64] & (1ULL << (bit % 64))) != 0;
+        }
+        if (present) {
+            return true;
+        }
+    }
+    return false;
+}
+
+double BloomFilter::expected_false_positive_rate() const {
+    // 任一层误判即误判：1 - ∏(1 - p_i)
+    double k = static_cast<double>(hash_count);
+    double pass = 1.0;
+    for (const Layer& layer : layers) {
+        pass *= 1.0 - std::pow(1.0 - std::exp(-k * layer.key_count / layer.bit_count), k);
+    }
+    return 1.0 - pass;
+}
+
+size_t BloomFilter::memory_bytes() const {
+    size_t bytes = 0;
+    for (const Layer& layer : layers) {
+        bytes += layer.bits.capacity() * sizeof(uint64_t);
+    }
+    return bytes;
+}
+
+BlockedBloomFilter::BlockedBloomFilter(size_t bits_per_key)
+    : bits_per_key(std::max<size_t>(1, bits_per_key)), hash_count(bloom_hash_count(this->bits_per_key)) {}
+
+void BlockedBloomFilter::add_layer(size_t capacity) {
+    Layer layer;
+    layer.block_count = std::max<size_t>(1, (capacity * bits_per_key + 511) / 512);
+    layer.capacity = layer.block_count * 512 / bits_per_key;
+    layer.blocks.assign(layer.block_count * BLOCK_WORDS, 0);
+    layers.push_back(std::move(layer));
+}
+
+void BlockedBloomFilter::build(const std::vector<uint64_t>& keys) {
+    layers.clear();
+    key_count = 0;
+    add_layer(keys.size());
+    for (uint64_t key : keys) {
+        insert(key);
+    }
+}
+
+void BlockedBloomFilter::insert(uint64_t key) {
+    if (layers.empty()) {
+        build({});
+    }
+    if (layers.back().key_count >= layers.back().capacity) {
+        add_layer(layers.back().capacity * 2);
+    }
+    Layer& layer = layers.back();
+    uint64_t h = filter_hash(key);
+    // 高32位选块（乘法取模），其余哈希位每9位给出块内一个位
+    uint64_t* block = layer.blocks.data() + ((h >> 32) * layer.block_count >> 32) * BLOCK_WORDS;
+    uint64_t bit_source = filter_hash(h);
+    for (size_t i = 0; i < hash_count; ++i) {
+        if (i % 7 == 0 && i > 0) {
+            bit_source = filter_hash(bit_source);
+        }
+        size_t bit = (bit_source >> ((i % 7) * 9)) & 511;
+        block[bit / 64] |= 1ULL << (bit % 64);
+    }
+    ++layer.key_count;
+    ++key_count;
+}
+
+bool BlockedBloomFilter::may_contain(uint64_t key) const {
+    uint64_t h = filter_hash(key);
+    for (const Layer& layer : layers) {
+        const uint64_t* block = layer.blocks.data() + ((h >> 32) * layer.block_count >> 32) * BLOCK_WORDS;
+        uint64_t bit_source = filter_hash(h);
+        bool present = true;
+        for (size_t i = 0; i < hash_count && present; ++i) {
+            if (i % 7 == 0 && i > 0) {
+                bit_source = filter_hash(bit_source);
+            }
+            size_t bit = (bit_source >> ((i % 7) * 9)) & 511;
+            present = (block[bit / 64] & (1ULL << (bit % 64))) != 0;
+        }
+        if (present) {
+            return true;
+        }
+    }
+    return false;
+}
+
+double BlockedBloomFilter::expected_false_positive_rate() const {
+    // 按块内的平均装载估算（忽略块间装载不均带来的少量额外误判），各层按1 - ∏(1 - p_i)合并
+    double k = static_cast<double>(hash_count);
+    double pass = 1.0;
+    for (const Layer& layer : layers) {
+        double keys_per_block = static_cast<double>(layer.key_count) / layer.block_count;
+        pass *= 1.0 - std::pow(1.0 - std::exp(-k * keys_per_block / 512.0), k);
+    }
+    return 1.0 - pass;
+}
+
+size_t BlockedBloomFilter::memory_bytes() const {
+    size_t bytes = 0;
+    for (const Layer& layer : layers) {
+        bytes += layer.blocks.capacity() * sizeof(uint64_t);
+    }
+    return bytes;
+}
+
+QuotientFilter::QuotientFilter(size_t bits_per_key) : bits_per_key(std::max<size_t>(4, bits_per_key)) {}
+
+void QuotientFilter::allocate(size_t q, size_t r) {
+    quotient_bits = q;
+    remainder_bits = r;
+    slot_count = size_t(1) << q;
+    slots.assign((slot_count * (r + 3) + 63) / 64 + 1, 0);
+    key_count = 0;
+}
+
+uint64_t QuotientFilter::get_slot(size_t slot) const {
+    size_t width = remainder_bits + 3;
+    size_t bit = slot * width;
+    size_t word = bit / 64, offset = bit % 64;
+    uint64_t value = slots[word] >> offset;
+    if (offset + width > 64) {
+        value |= slots[word + 1] << (64 - offset);
+    }
+    return value & ((1ULL << width) - 1);
+}
+
+void QuotientFilter::set_slot(size_t slot, uint64_t value) {
+    size_t width = remainder_bits + 3;
+    size_t bit = slot * width;
+    size_t word = bit / 64, offset = bit % 64;
+    uint64_t mask = (1ULL << width) - 1;
+    slots[word] = (slots[word] & ~(mask << offset)) | (value << offset);
+    if (offset + width > 64) {
+        size_t spill = 64 - offset;
+        slots[word + 1] = (slots[word + 1] & ~(mask >> spill)) | (value >> spill);
+    }
+}
+
+void QuotientFilter::build(const std::vector<uint64_t>& keys) {
+    // 装载率不超过75%；每槽占r + 3位，r取bits_per_key - 3
+    size_t q = 6;
+    while ((size_t(1) << q) * 3 < keys.size() * 4) {
+        ++q;
+    }
+    allocate(q, std::min<size_t>(bits_per_key - 3, 60 - q));
+    for (uint64_t key : keys) {
+        insert(key);
+    }
+}
+
+size_t QuotientFilter::run_start(size_t fq) const {
+    // 退回到簇的起点，再数occupied位前进到fq的游程
+    size_t b = fq;
+    while (flags(b) & SHIFTED) {
+        b = prev(b);
+    }
+    size_t s = b;
+    while (b != fq) {
+        do {
+            s = next(s);
+        } while (flags(s) & CONTINUATION);
+        do {
+            b = next(b);
+        } while (!(flags(b) & OCCUPIED));
+    }
+    return s;
+}
+
+void QuotientFilter::insert(uint64_t key) {
+    if (slot_count == 0) {
+        build({});
+    }
+    if ((key_count + 1) * 10 > slot_count * 9) {
+        grow();
+    }
+    uint64_t h = filter_hash(key);
+    uint64_t fingerprint = h >> (64 - quotient_bits - remainder_bits);
+    insert_fingerprint(fingerprint >> remainder_bits, fingerprint & ((1ULL << remainder_bits) - 1));
+}
+
+void QuotientFilter::insert_fingerprint(uint64_t fq, uint64_t fr) {
+    ++key_count;
+    if (slot_empty(fq)) {
+        set_slot(fq, (fr << 3) | OCCUPIED);
+        return;
+    }
+    
+    bool run_exists = flags(fq) & OCCUPIED;
+    set_slot(fq, get_slot(fq) | OCCUPIED);
+    size_t s = run_start(fq);
+    
+    // 已有游程时追加在游程末尾，否则在s处开始新游程
+    uint64_t entry_flags = 0;
+    if (run_exists) {
+        do {
+            s = next(s);
+        } while (flags(s) & CONTINUATION);
+        entry_flags |= CONTINUATION;
+    }
+    if (s != fq) {
+        entry_flags |= SHIFTED;
+    }
+    
+    // 从s起把条目依次右移一槽直到遇到空槽；occupied位属于槽位本身，不随条目移动
+    uint64_t entry = fr;
+    while (true) {
+        uint64_t displaced = get_slot(s);
+        set_slot(s, (entry << 3) | (displaced & OCCUPIED) | entry_flags);
+        if ((displaced & 7) == 0) {
+            break;
+        }
+        entry = displaced >> 3;
+        entry_flags = (displaced & CONTINUATION) | SHIFTED;
+        s = next(s);
+    }
+}
+
+void QuotientFilter::grow() {
+    if (remainder_bits <= 1) {
+        throw std::length_error("Quotient filter full");
+    }
+    
+    // 从一个空槽之后开始遍历一圈：occupied位依次入队，每个游程起点出队一个商
+    std::vector<uint64_t> fingerprints;
+    fingerprints.reserve(key_count);
+    size_t start = 0;
+    while (!slot_empty(start)) {
+        start = next(start);
+    }
+    std::deque<size_t> quotients;
+    size_t current = 0;
+    for (size_t i = 1; i <= slot_count; ++i) {
+        size_t slot = (start + i) & (slot_count - 1);
+        uint64_t value = get_slot(slot);
+        if (value & OCCUPIED) {
+            quotients.push_back(slot);
+        }
+        if ((value & 7) == 0) {
+            continue;
+        }
+        if (!(value & CONTINUATION)) {
+            current = quotients.front();
+            quotients.pop_front();
+        }
+        fingerprints.push_back((static_cast<uint64_t>(current) << remainder_bits) | (value >> 3));
+    }
+    
+    // 指纹总位数不变：商多一位，余数少一位
+    size_t r = remainder_bits - 1;
+    allocate(quotient_bits + 1, r);
+    for (uint64_t fingerprint : fingerprints) {
+        insert_fingerprint(fingerprint >> r, fingerprint & ((1ULL << r) - 1));
+    }
+}
+
+bool QuotientFilter::may_contain(uint64_t key) const {
+    if (slot_count == 0) {
+        return false;
+    }
+    uint64_t h = filter_hash(key);
+    uint64_t fingerprint = h >> (64 - quotient_bits - remainder_bits);
+    size_t fq = fingerprint >> remainder_bits;
+    uint64_t fr = fingerprint & ((1ULL << remainder_bits) - 1);
+    if (!(flags(fq) & OCCUPIED)) {
+        return false;
+    }
+    size_t s = run_start(fq);
+    do {
+        if (remainder(s) == fr) {
+            return true;
+        }
+        s = next(s);
+    } while (flags(s) & CONTINUATION);
+    return false;
+}
+
+double QuotientFilter::expected_false_positive_rate() const {
+    if (slot_count == 0) {
+        return 0.0;
+    }
+    double load = static_cast<double>(key_count) / slot_count;
+    return 1.0 - std::exp(-load / std::ldexp(1.0, static_cast<int>(remainder_bits)));
+}
+
+std::unique_ptr<MembershipFilter> MembershipFilterFactory::create_filter(const std::string& type,
+                                                                         size_t bits_per_key) {
+    if (type == "none") {
+        return nullptr;
+    } else if (type == "bloom") {
+        return std::make_unique<BloomFilter>(bits_per_key);
+    } else if (type == "blocked-bloom") {
+        return std::make_unique<BlockedBloomFilter>(bits_per_key);
+    } else if (type == "quotient") {
+        return std::make_unique<QuotientFilter>(bits_per_key);
+    } else {
+        throw std::invalid_argument("Unknown membership filter: " + type);
+    }
+}
+
+// 批量调度实现
+const char* batch_schedule_name(BatchSchedule schedule) {
+    switch (schedule) {
+        case BatchSchedule::FIFO: return "FIFO";
+        case BatchSchedule::SCAN: return "SCAN";
+        case BatchSchedule::CSCAN: return "C-SCAN";
+        case BatchSchedule::LOOK: return "LOOK";
+        case BatchSchedule::WRAP_LOOK: return "WRAP-LOOK";
+        case BatchSchedule::RAO: return "RAO";
+    }
+    return "unknown";
+}
+
+BatchSchedule parse_batch_schedule(const std::string& name) {
+    if (name == "fifo") return BatchSchedule::FIFO;
+    if (name == "scan") return BatchSchedule::SCAN;
+    if (name == "cscan") return BatchSchedule::CSCAN;
+    if (name == "look") return BatchSchedule::LOOK;
+    if (name == "wraplook") return BatchSchedule::WRAP_LOOK;
+    if (name == "rao") return BatchSchedule::RAO;
+    throw std::invalid_argument("Unknown batch schedule: " + name);
+}
+
+std::vector<BatchStop> schedule_batch(const std::vector<size_t>& positions, size_t head,
+                                      size_t block_count, BatchSchedule schedule) {
+    std::vector<BatchStop> stops;
+    if (schedule == BatchSchedule::FIFO) {
+        for (size_t i = 0; i < positions.size(); ++i) {
+            if (positions[i] != std::string::npos) {
+                stops.push_back({positions[i], i});
+            }
+        }
+        return stops;
+    }
+    
+    // 以磁头为界分为正向和反向两组
+    std::vector<BatchStop> forward, backward;
+    for (size_t i = 0; i < positions.size(); ++i) {
+        if (positions[i] == std::string::npos) {
+            continue;
+        }
+        (positions[i] >= head ? forward : backward).push_back({positions[i], i});
+    }
+    auto ascending = [](const BatchStop& a, const BatchStop& b) {
+        return a.position < b.position || (a.position == b.position && a.request < b.request);
+    };
+    std::sort(forward.begin(), forward.end(), ascending);
+    std::sort(backward.begin(), backward.end(), ascending);
+    
+    stops = forward;
+    if (backward.empty() || block_count == 0) {
+        return stops;
+    }
+    
+    size_t end_of_tape = block_count - 1;
+    if (schedule == BatchSchedule::SCAN || schedule == BatchSchedule::CSCAN) {
+        if (stops.empty() || stops.back().position != end_of_tape) {
+            stops.push_back({end_of_tape, std::string::npos});
+        }
+    }
+    
+    if (schedule == BatchSchedule::CSCAN) {
+        // 回卷到起点后继续正向访问
+        stops.push_back({0, std::string::npos});
+        stops.insert(stops.end(), backward.begin(), backward.end());
+    } else {
+        // SCAN/LOOK反向访问剩余请求
+        stops.insert(stops.end(), backward.rbegin(), backward.rend());
+    }
+    return stops;
+}
+
+static double thread_cpu_ms() {
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+// 按物理坐标的往返调度（WRAP-LOOK）
+static std::vector<BatchStop> schedule_wrap_look(const std::vector<size_t>& positions, const TapeDevice& tape) {
+    // 趟方向为磁头所在磁道的方向；沿该方向的行程坐标越大越靠后
+    TapeCoordinate head = tape.get_head_coordinate();
+    bool direction = head.forward();
+    auto travel = [](const TapeCoordinate& c, bool forward) {
+        return forward ? static_cast<int64_t>(c.longitudinal) : -static_cast<int64_t>(c.longitudinal);
+    };
+    
+    // 第一趟：同方向且在磁头前方；第二趟：反方向磁道；第三趟：同方向但在磁头后方
+    struct Candidate {
+        int64_t key;
+        size_t wrap;
+        BatchStop stop;
+    };
+    std::vector<Candidate> passes[3];
+    for (size_t i = 0; i < positions.size(); ++i) {
+        if (positions[i] == std::string::npos) {
+            continue;
+        }
+        TapeCoordinate c = tape.get_coordinate(positions[i]);
+        if (c.forward() != direction) {
+            passes[1].push_back({travel(c, !direction), c.wrap, {positions[i], i}});
+        } else if (travel(c, direction) >= travel(head, direction)) {
+            passes[0].push_back({travel(c, direction), c.wrap, {positions[i], i}});
+        } else {
+            passes[2].push_back({travel(c, direction), c.wrap, {positions[i], i}});
+        }
+    }
+    
+    std::vector<BatchStop> stops;
+    for (auto& pass : passes) {
+        std::sort(pass.begin(), pass.end(), [](const Candidate& a, const Candidate& b) {
+            return std::tie(a.key, a.wrap, a.stop.request) < std::tie(b.key, b.wrap, b.stop.request);
+        });
+        for (const Candidate& candidate : pass) {
+            stops.push_back(candidate.stop);
+        }
+    }
+    return stops;
+}
+
+std::vector<BatchStop> schedule_batch(const std::vector<size_t>& positions, const TapeDevice& tape,
+                                      BatchSchedule schedule, BatchStats* stats) {
+    double start = stats ? thread_cpu_ms() : 0.0;
+    
+    std::vector<BatchStop> stops;
+    if (schedule == BatchSchedule::WRAP_LOOK) {
+        stops = schedule_wrap_look(positions, tape);
+    } else if (schedule == BatchSchedule::RAO) {
+        stops = RaoOptimizer(stats ? stats->rao_time_budget_ms : 2.0).optimize(positions, tape);
+    } else {
+        stops = schedule_batch(positions, tape.get_data_position(), tape.get_block_count(), schedule);
+    }
+    
+    if (stats) {
+        stats->batches++;
+        stats->schedule_cpu_ms += thread_cpu_ms() - start;
+    }
+    return stops;
+}
+
+double RaoOptimizer::estimate_seek_time(const std::vector<BatchStop>& stops, const TapeDevice& tape) {
+    const SeekModel& model = tape.get_seek_model();
+    TapeCoordinate current = tape.get_head_coordinate();
+    double time = 0.0;
+    for (const BatchStop& stop : stops) {
+        TapeCoordinate next = tape.get_coordinate(stop.position);
+        time += model.seek_time(current, next);
+        current = next;
+    }
+    return time;
+}
+
+std::vector<BatchStop> RaoOptimizer::optimize(const std::vector<size_t>& positions, const TapeDevice& tape) const {
+    double deadline = thread_cpu_ms() + time_budget_ms;
+    
+    // 节点0为磁头，节点1..n为有效请求
+    std::vector<BatchStop> requests;
+    for (size_t i = 0; i < positions.size(); ++i) {
+        if (positions[i] != std::string::npos) {
+            requests.push_back({positions[i], i});
+        }
+    }
+    size_t n = requests.size();
+    if (n <= 1) {
+        return requests;
+    }
+    
+    std::vector<TapeCoordinate> coords;
+    coords.reserve(n + 1);
+    coords.push_back(tape.get_head_coordinate());
+    for (const BatchStop& request : requests) {
+        coords.push_back(tape.get_coordinate(request.position));
+    }
+    
+    // 寻道耗时矩阵（非对称：反向移动更贵）
+    const SeekModel& model = tape.get_seek_model();
+    std::vector<double> cost((n + 1) * (n + 1), 0.0);
+    for (size_t i = 0; i <= n; ++i) {
+        for (size_t j = 1; j <= n; ++j) {
+            cost[i * (n + 1) + j] = model.seek_time(coords[i], coords[j]);
+        }
+    }
+    auto c = [&cost, n](size_t i, size_t j) { return cost[i * (n + 1) + j]; };
+    auto path_cost = [&c](const std::vector<size_t>& path) {
+        double total = 0.0;
+        for (size_t k = 1; k < path.size(); ++k) {
+            total += c(path[k - 1], path[k]);
+        }
+        return total;
+    };
+    
+    // 初始解一：最近邻贪心
+    std::vector<size_t> path = {0};
+    std::vector<bool> visited(n + 1, false);
+    for (size_t step = 0; step < n; ++step) {
+        size_t from = path.back();
+        size_t best = 0;
+        for (size_t j = 1; j <= n; ++j) {
+            if (!visited[j] && (best == 0 || c(from, j) < c(from, best))) {
+                best = j;
+            }
+        }
+        visited[best] = true;
+        path.push_back(best);
+    }
+    
+    // 初始解二、三：LOOK和WRAP-LOOK（按请求下标映射回节点）
+    std::vector<size_t> node_of(positions.size(), 0);
+    for (size_t k = 0; k < n; ++k) {
+        node_of[requests[k].request] = k + 1;
+    }
+    for (const auto& seed : {schedule_batch(positions, tape.get_data_position(), tape.get_block_count(),
+                                            BatchSchedule::LOOK),
+                             schedule_wrap_look(positions, tape)}) {
+        std::vector<size_t> seed_path = {0};
+        for (const BatchStop& stop : seed) {
+            seed_path.push_back(node_of[stop.request]);
+        }
+        if (path_cost(seed_path) < path_cost(path)) {
+            path = std::move(seed_path);
+        }
+    }
+    
+    // 2-opt：反转path[i..j]；非对称代价用正向/反向前缀和O(1)求出区间内部代价
+    std::vector<double> fwd(n + 1, 0.0), bwd(n + 1, 0.0);
+    auto two_opt = [&]() {
+        for (size_t k = 1; k <= n; ++k) {
+            fwd[k] = fwd[k - 1] + c(path[k - 1], path[k]);
+            bwd[k] = bwd[k - 1] + c(path[k], path[k - 1]);
+        }
+        for (size_t i = 1; i < n && thread_cpu_ms() < deadline; ++i) {
+            for (size_t j = i + 1; j <= n; ++j) {
+                double before = c(path[i - 1], path[i]) + (fwd[j] - fwd[i]);
+                double after = c(path[i - 1], path[j]) + (bwd[j] - bwd[i]);
+                if (j < n) {
+                    before += c(path[j], path[j + 1]);
+                    after += c(path[i], path[j + 1]);
+                }
+                if (after < before - 1e-12) {
+                    std::reverse(path.begin() + i, path.begin() + j + 1);
+                    return true;
+                }
+            }
+        }
+        return false;
+    };
+    
+    // Or-opt：把path[i..e]（1到3个节点，保持方向）移到path[j]之后，适合方向相关的非对称代价
+    auto or_opt = [&]() {
+        for (size_t len = 1; len <= 3 && len < n; ++len) {
+            for (size_t i = 1; i + len - 1 <= n && thread_cpu_ms() < deadline; ++i) {
+                size_t e = i + len - 1;
+                double removed = c(path[i - 1], path[i]);
+                if (e < n) {
+                    removed += c(path[e], path[e + 1]) - c(path[i - 1], path[e + 1]);
+                }
+                for (size_t j = 0; j <= n; ++j) {
+                    if (j + 1 >= i && j <= e) {
+                        continue;
+                    }
+                    double inserted = c(path[j], path[i]);
+                    if (j < n) {
+                        inserted += c(path[e], path[j + 1]) - c(path[j], path[j + 1]);
+                    }
+                    if (inserted < removed - 1e-12) {
+                        std::vector<size_t> segment(path.begin() + i, path.begin() + e + 1);
+                        path.erase(path.begin() + i, path.begin() + e + 1);
+                        size_t at = (j < i) ? j + 1 : j + 1 - len;
+                        path.insert(path.begin() + at, segment.begin(), segment.end());
+                        return true;
+                    }
+                }
+            }
+        }
+        return false;
+    };
+    
+    while (thread_cpu_ms() < deadline && (two_opt() || or_opt())) {
+    }
+    
+    std::vector<BatchStop> stops;
+    stops.reserve(n);
+    for (size_t k = 1; k <= n; ++k) {
+        stops.push_back(requests[path[k] - 1]);
+    }
+    return stops;
+}
+
+// IndexPageCodec 实现
+size_t IndexPageCodec::put_varint(uint64_t value, uint8_t* out) {
+    size_t length = 0;
+    while (value >= 0x80) {
+        out[length++] = static_cast<uint8_t>(value | 0x80);
+        value >>= 7;
+    }
+    out[length++] = static_cast<uint8_t>(value);
+    return length;
+}
+
+const uint8_t* IndexPageCodec::get_varint(const uint8_t* in, const uint8_t* end, uint64_t& value) {
+    value = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7) {
+        if (in == end) {
+            throw std::runtime_error("Truncated varint in index page");
+        }
+        uint8_t byte = *in++;
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return in;
+        }
+    }
+    throw std::runtime_error("Varint longer than 10 bytes in index page");
+}
+
+std::vector<std::vector<uint8_t>> IndexPageCodec::encode(std::vector<Entry> entries, size_t page_size) {
+    if (page_size < HEADER_BYTES + MAX_ENTRY_BYTES) {
+        throw std::invalid_argument("Index page size too small: " + std::to_string(page_size));
+    }
+    std::sort(entries.begin(), entries.end());
+    
+    std::vector<std::vector<uint8_t>> pages;
+    std::vector<uint8_t> page;
+    uint32_t count = 0;
+    uint64_t prev_id = 0;
+    uint64_t prev_pos = 0;
+    auto finish_page = [&]() {
+        std::memcpy(page.data() + 4, &count, sizeof(count));
+        pages.push_back(std::move(page));
+    };
+    auto start_page = [&]() {
+        page.assign(HEADER_BYTES, 0);
+        page.reserve(page_size);
+        std::memcpy(page.data(), &MAGIC, sizeof(MAGIC));
+        count = 0;
+        prev_id = 0;
+        prev_pos = 0;
+    };
+    
+    start_page();
+    for (const auto& [id, position] : entries) {
+        uint8_t encoded[MAX_ENTRY_BYTES];
+        // 新页从0重新差分，满页时需按新基准重新编码当前条目
+        for (int attempt = 0; attempt < 2; ++attempt) {
+            int64_t pos_delta = static_cast<int64_t>(position - prev_pos);
+            uint64_t zigzag = (static_cast<uint64_t>(pos_delta) << 1) ^ static_cast<uint64_t>(pos_delta >> 63);
+            size_t length = put_varint(id - prev_id, encoded);
+            length += put_varint(zigzag, encoded + length);
+            if (page.size() + length <= page_size) {
+                page.insert(page.end(), encoded, encoded + length);
+                break;
+            }
+            finish_page();
+            start_page();
+        }
+        ++count;
+        prev_id = id;
+        prev_pos = position;
+    }
+    if (count > 0) {
+        finish_page();
+    }
+    return pages;
+}
+
+void IndexPageCodec::decode(const uint8_t* data, size_t size, std::vector<Entry>& out) {
+    uint32_t magic = 0;
+    uint32_t count = 0;
+    if (size < HEADER_BYTES) {
+        throw std::runtime_error("Index page shorter than its header");
+    }
+    std::memcpy(&magic, data, sizeof(magic));
+    std::memcpy(&count, data + 4, sizeof(count));
+    if (magic != MAGIC) {
+        throw std::runtime_error("Bad index page magic");
+    }
+    
+    const uint8_t* in = data + HEADER_BYTES;
+    const uint8_t* end = data + size;
+    uint64_t id = 0;
+    uint64_t position = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        uint64_t id_delta = 0;
+        uint64_t zigzag = 0;
+        in = get_varint(in, end, id_delta);
+        in = get_varint(in, end, zigzag);
+        id += id_delta;
+        position += (zigzag >> 1) ^ (~(zigzag & 1) + 1);
+        out.emplace_back(id, position);
+    }
+    if (in != end) {
+        throw std::runtime_error("Index page has trailing bytes after " + std::to_string(count) + " entries");
+    }
+}
+
+// IndexStrategy 实现
+double IndexStrategy::on_append([[maybe_unused]] TapeDevice& tape, [[maybe_unused]] const TapeBlockView& block,
+                                [[maybe_unused]] size_t position) {
+    throw std::logic_error(get_name() + " does not support incremental index maintenance");
+}
+
+void IndexStrategy::collect_data_blocks(const TapeBlockStore& store, size_t block_count, size_t threads,
+                                        std::vector<std::pair<uint64_t, size_t>>& out) {
+    out.clear();
+    threads = std::max<size_t>(1, std::min(threads, block_count / 4096 + 1));
+    if (threads == 1) {
+        for (size_t i = 0; i < block_count; ++i) {
+            if (!store.is_index(i)) {
+                out.emplace_back(store.block_id(i), i);
+            }
+        }
+        return;
+    }
+    
+    // 每个线程收集一段连续区间，按区间顺序拼接即为位置升序
+    std::vector<std::vector<std::pair<uint64_t, size_t>>> parts(threads);
+    std::vector<std::function<void()>> tasks;
+    for (size_t t = 0; t < threads; ++t) {
+        tasks.emplace_back([&store, &parts, block_count, threads, t]() {
+            size_t begin = block_count * t / threads;
+            size_t end = block_count * (t + 1) / threads;
+            std::vector<std::pair<uint64_t, size_t>>& part = parts[t];
+            part.reserve(end - begin);
+            for (size_t i = begin; i < end; ++i) {
+                if (!store.is_index(i)) {
+                    part.emplace_back(store.block_id(i), i);
+                }
+            }
+        });
+    }
+    WorkStealingPool pool(threads);
+    pool.run(std::move(tasks));
+    
+    size_t total = 0;
+    for (const auto& part : parts) {
+        total += part.size();
+    }
+    out.reserve(total);
+    for (const auto& part : parts) {
+        out.insert(out.end(), part.begin(), part.end());
+    }
+}
+
+double IndexStrategy::scan_data_blocks(TapeDevice& tape, size_t block_count,
+                                       std::vector<std::pair<uint64_t, size_t>>& out) {
+    double time = tape.seek_to_block(0);
+    time += tape.scan_blocks(block_count);
+    collect_data_blocks(tape.get_store(), block_count, build_threads, out);
+    return time;
+}
+
+std::pair<size_t, double> IndexStrategy::resolve_position([[maybe_unused]] TapeDevice& tape,
+                                                          [[maybe_unused]] uint64_t data_id) {
+    return {std::string::npos, 0.0};
+}
+
+void IndexStrategy::resolve_positions(TapeDevice& tape, const std::vector<uint64_t>& data_ids,
+                                      std::vector<size_t>& positions, std::vector<double>& times) {
+    positions.resize(data_ids.size());
+    times.resize(data_ids.size());
+    for (size_t i = 0; i < data_ids.size(); ++i) {
+        std::tie(positions[i], times[i]) = resolve_position(tape, data_ids[i]);
+    }
+}
+
+std::vector<std::pair<size_t, double>> IndexStrategy::find_blocks(TapeDevice& tape,
+                                                                  const std::vector<uint64_t>& data_ids,
+                                                                  BatchSchedule schedule, BatchStats* stats) {
+    std::vector<std::pair<size_t, double>> results;
+    results.reserve(data_ids.size());
+    
+    if (!supports_position_lookup()) {
+        for (uint64_t id : data_ids) {
+            results.push_back(find_block(tape, id));
+        }
+        return results;
+    }
+    
+    // 先由索引解析出全部位置，解析耗时计入各自的查询
+    std::vector<size_t> positions;
+    std::vector<double> times;
+    resolve_positions(tape, data_ids, positions, times);
+    for (size_t i = 0; i < data_ids.size(); ++i) {
+        results.emplace_back(std::string::npos, times[i]);
+    }
+    
+    // 再按调度顺序访问数据块；换向/回卷的寻道计入下一个被服务的请求
+    double pending = 0.0;
+    for (const BatchStop& stop : schedule_batch(positions, tape, schedule, stats)) {
+        if (stop.request == std::string::npos) {
+            pending += tape.seek_to_block(stop.position);
+            continue;
+        }
+        auto [pos, time] = read_and_verify(tape, stop.position, data_ids[stop.request]);
+        results[stop.request].first = pos;
+        results[stop.request].second += time + pending;
+        pending = 0.0;
+    }
+    
+    return results;
+}
+
+std::pair<size_t, double> IndexStrategy::read_and_verify(TapeDevice& tape, size_t position, uint64_t data_id) {
+    double time = tape.seek_to_block(position);
+    
+    auto [block, read_time] = tape.view_current_block();
+    time += read_time;
+    
+    if (block.block_id != data_id) {
+        return {std::string::npos, time};
+    }
+    
+    return {position, time};
+}
+
+std::pair<BlockAddress, double> IndexStrategy::place_index_block(TapeDevice& tape, const TapeBlock& block,
+                                                                 size_t anchor) {
+    BlockAddress address;
+    double time = 0.0;
+    switch (placement) {
+        case IndexPlacement::End:
+            address = {TapeRegion::Data, tape.get_block_count()};
+            time = tape.write_block(block);
+            break;
+        case IndexPlacement::Interleaved:
+            address.region = TapeRegion::Interleaved;
+            std::tie(address.position, time) = tape.write_interleaved_block(anchor, block);
+            break;
+        case IndexPlacement::Partition:
+            address.region = TapeRegion::IndexPartition;
+            std::tie(address.position, time) = tape.write_index_partition_block(block);
+            break;
+    }
+    ++tape_index_blocks;
+    tape_index_bytes += block.data.size();
+    // 索引块只追加不改写，已缓存的块仍然有效；只需让下次访问索引分区时读入新写的块
+    partition_loaded = false;
+    return {address, time};
+}
+
+// 把块地址编码为缓存键：高8位为区域，低56位为位置
+static uint64_t index_cache_key(const BlockAddress& address) {
+    return (static_cast<uint64_t>(address.region) << 56) | address.position;
+}
+
+std::pair<TapeBlockView, double> IndexStrategy::read_index_block(TapeDevice& tape, const BlockAddress& address,
+                                                                 bool top_level) {
+    uint64_t key = index_cache_key(address);
+    auto it = index_cache.find(key);
+    if (it != index_cache.end()) {
+        cache_hits++;
+        CachedIndexBlock& entry = it->second;
+        if (!entry.pinned) {
+            cache_lru.splice(cache_lru.begin(), cache_lru, entry.lru_pos);
+        }
+        return {{entry.block_id, entry.data.data(), entry.data.size(), true}, 0.0};
+    }
+    cache_misses++;
+    
+    // 整体读入索引分区：一次定位后顺序读完，比逐块随机定位便宜
+    if (address.region == TapeRegion::IndexPartition && cache_policy == IndexCachePolicy::PinAll &&
+        !partition_loaded) {
+        size_t partition_blocks = tape.get_block_count(TapeRegion::IndexPartition);
+        double time = tape.seek_to(TapeRegion::IndexPartition, 0);
+        for (size_t i = 0; i < partition_blocks; ++i) {
+            time += tape.view_current_block().second;
+            uint64_t block_key = index_cache_key({TapeRegion::IndexPartition, i});
+            if (index_cache.count(block_key) == 0) {
+                cache_index_block(tape, block_key, true);
+            }
+            if (i + 1 < partition_blocks) {
+                time += tape.move_forward(1);
+            }
+        }
+        partition_loaded = true;
+        cache_peak_bytes = std::max(cache_peak_bytes, cache_bytes);
+        const CachedIndexBlock& entry = index_cache.at(key);
+        return {{entry.block_id, entry.data.data(), entry.data.size(), true}, time};
+    }
+    
+    double time = tape.seek_to(address);
+    auto [block, read_time] = tape.view_current_block();
+    time += read_time;
+    
+    bool keep = false;
+    bool pinned = false;
+    switch (cache_policy) {
+        case IndexCachePolicy::None: break;
+        case IndexCachePolicy::PinTop: keep = pinned = top_level; break;
+        case IndexCachePolicy::PinAll: keep = pinned = true; break;
+        case IndexCachePolicy::Lru: keep = cache_capacity_blocks > 0; break;
+    }
+    if (!keep) {
+        return {block, time};
+    }
+    
+    const CachedIndexBlock& entry = cache_index_block(tape, key, pinned);
+    TapeBlockView view{entry.block_id, entry.data.data(), entry.data.size(), true};
+    
+    // 超出容量时从LRU表尾淘汰（刚插入的块在表头）
+    while (cache_lru.size() > cache_capacity_blocks) {
+        auto victim = index_cache.find(cache_lru.back());
+        cache_bytes -= victim->second.data.size();
+        index_cache.erase(victim);
+        cache_lru.pop_back();
+    }
+    // 峰值在淘汰之后统计，LRU缓存的峰值不超过容量
+    cache_peak_bytes = std::max(cache_peak_bytes, cache_bytes);
+    return {view, time};
+}
+
+const IndexStrategy::CachedIndexBlock& IndexStrategy::cache_index_block(TapeDevice& tape, uint64_t key,
+                                                                        bool pinned) {
+    const TapeBlockStore& store = tape.get_store(tape.get_current_region());
+    size_t position = tape.get_current_position();
+    CachedIndexBlock entry;
+    entry.block_id = store.block_id(position);
+    store.copy_payload(position, entry.data);
+    entry.pinned = pinned;
+    if (!pinned) {
+        cache_lru.push_front(key);
+        entry.lru_pos = cache_lru.begin();
+    }
+    cache_bytes += entry.data.size();
+    return index_cache.emplace(key, std::move(entry)).first->second;
+}
+
+void IndexStrategy::set_index_cache(IndexCachePolicy policy, size_t lru_blocks) {
+    cache_policy = policy;
+    cache_capacity_blocks = lru_blocks;
+    clear_index_cache();
+}
+
+void IndexStrategy::clear_index_cache() {
+    index_cache.clear();
+    cache_lru.clear();
+    cache_bytes = 0;
+    partition_loaded = false;
+}
+
+std::string IndexStrategy::index_cache_stats() const {
+    std::stringstream ss;
+    ss << "Index cache: " << index_cache_policy_name(cache_policy);
+    if (cache_policy == IndexCachePolicy::Lru) {
+        ss << "(" << cache_capacity_blocks << ")";
+    }
+    ss << " (" << index_cache.size() << " blocks, " << cache_bytes << " bytes, peak " << cache_peak_bytes
+       << " bytes, " << cache_hits << " hits / " << cache_misses << " misses)";
+    return ss.str();
+}
+
+const char* index_cache_policy_name(IndexCachePolicy policy) {
+    switch (policy) {
+        case IndexCachePolicy::None: return "none";
+        case IndexCachePolicy::PinTop: return "pin-top";
+        case IndexCachePolicy::PinAll: return "pin-all";
+        case IndexCachePolicy::Lru: return "lru";
+    }
+    return "unknown";
+}
+
+IndexCachePolicy parse_index_cache_policy(const std::string& name) {
+    if (name == "none") return IndexCachePolicy::None;
+    if (name == "pin-top") return IndexCachePolicy::PinTop;
+    if (name == "pin-all") return IndexCachePolicy::PinAll;
+    if (name == "lru") return IndexCachePolicy::Lru;
+    throw std::invalid_argument("Unknown index cache policy: " + name);
+}
+
+const char* index_placement_name(IndexPlacement placement) {
+    switch (placement) {
+        case IndexPlacement::End: return "end";
+        case IndexPlacement::Interleaved: return "interleaved";
+        case IndexPlacement::Partition: return "partition";
+    }
+    return "unknown";
+}
+
+IndexPlacement parse_index_placement(const std::string& name) {
+    if (name == "end") return IndexPlacement::End;
+    if (name == "interleaved") return IndexPlacement::Interleaved;
+    if (name == "partition") return IndexPlacement::Partition;
+    throw std::invalid_argument("Unknown index placement: " + name);
+}
+
+TapeDevice TapeDevice::create_cursor() const {
+    TapeDevice cursor(block_size, read_speed, write_speed, seek_time_per_block);
+    cursor.blocks.share_from(blocks);
+    cursor.seek_model = seek_model->clone();
+    cursor.geometry = geometry;
+    cursor.cache_config = cache_config;
+    cursor.cache = cache ? cache->clone_empty() : nullptr;
+    cursor.index_partition_capacity = index_partition_capacity;
+    return cursor;
+}
+
+// NoIndexStrategy 实现
+double NoIndexStrategy::build_index(TapeDevice& tape) {
+    return 0.0; // 无索引，构建时间为0
+}
+
+std::pair<size_t, double> NoIndexStrategy::find_block(TapeDevice& tape, uint64_t data_id) {
+    size_t original_pos = tape.get_data_position();
+    
+    // 只访问ID列和标志列，扫描时不触及块数据
+    const TapeBlockStore& store = tape.get_store();
+    size_t block_count = store.size();
+    if (block_count == 0) {
+        return {std::string::npos, 0.0};
+    }
+    
+    // 从当前位置开始搜索，到末尾后回绕；模拟耗时按命中位置一次性计算
+    bool found = true;
+    size_t visited = 0;
+    size_t pos = store.find_data_block(original_pos, block_count, data_id);
+    if (pos != block_count) {
+        visited = pos - original_pos + 1;
+    } else {
+        pos = store.find_data_block(0, original_pos, data_id);
+        found = (pos != original_pos);
+        visited = found ? block_count - original_pos + pos + 1 : block_count;
+    }
+    
+    double time = tape.scan_blocks(visited);
+    
+    // 未找到
+    if (!found) {
+        return {std::string::npos, time};
+    }
+    return {pos, time};
+}
+
+std::string NoIndexStrategy::get_name() const {
+    return "No Index";
+}
+
+std::string NoIndexStrategy::get_stats() const {
+    return "No index used";
+}
+
+// FixedIntervalIndexStrategy 实现
+FixedIntervalIndexStrategy::FixedIntervalIndexStrategy(size_t interval, const std::string& container)
+    : interval(interval), index_map(IndexContainerFactory::create_container(container)) {}
+
+double FixedIntervalIndexStrategy::build_index(TapeDevice& tape) {
+    std::vector<std::pair<uint64_t, uint64_t>> entries;
+    open_entries.clear();
+    index_pages.clear();
+    page_stats = {};
+    clear_index_cache();
+    double time = 0.0;
+    size_t original_pos = tape.get_current_position();
+    
+    size_t block_count = tape.get_block_count();
+    
+    // 并行路径：先收集全部数据块再写索引块，扫描耗时按一次顺序读取计算
+    if (build_threads > 1 && block_count > 0) {
+        std::vector<std::pair<uint64_t, size_t>> data_blocks;
+        time += scan_data_blocks(tape, block_count, data_blocks);
+        entries.reserve(data_blocks.size());
+        for (const auto& [block_id, position] : data_blocks) {
+            entries.emplace_back(block_id, position);
+            time += add_data_block(tape, block_id, position);
+        }
+        if (!open_entries.empty()) {
+            time += write_open_entries(tape, data_blocks.back().second);
+        }
+        index_map->build(std::move(entries));
+        time += tape.seek_to_block(original_pos);
+        return time;
+    }
+    
+    // 回到起始位置；只扫描构建前已有的块，本次写入的索引块不参与
+    time += tape.seek_to_block(0);
+    
+    // 创建索引
+    for (size_t i = 0; i < block_count; ++i) {
+        // 读取当前块
+        auto [block, read_time] = tape.view_current_block();
+        time += read_time;
+        
+        // 如果是数据块，添加到索引
+        if (!block.is_index_block) {
+            entries.emplace_back(block.block_id, i);
+            time += add_data_block(tape, block.block_id, i);
+        }
+        
+        // 移动到下一个块
+        if (i < block_count - 1) {
+            time += tape.move_forward(1);
+        }
+    }
+    
+    // 写出最后一组不满interval的条目，使索引页覆盖构建时的全部数据块
+    if (!open_entries.empty()) {
+        time += write_open_entries(tape, open_entries.back().second);
+    }
+    index_map->build(std::move(entries));
+    
+    // 回到原始位置
+    time += tape.seek_to_block(original_pos);
+    
+    return time;
+}
+
+double FixedIntervalIndexStrategy::add_data_block(TapeDevice& tape, uint64_t block_id, size_t position) {
+    open_entries.emplace_back(block_id, position);
+    if (open_entries.size() < interval) {
+        return 0.0;
+    }
+    return write_open_entries(tape, position);
+}
+
+double FixedIntervalIndexStrategy::write_open_entries(TapeDevice& tape, size_t anchor) {
+    uint64_t last_id = open_entries.back().first;
+    page_stats.entries += open_entries.size();
+    double time = 0.0;
+    for (auto& page : IndexPageCodec::encode(std::move(open_entries), tape.get_block_size())) {
+        page_stats.bytes += page.size();
+        TapeBlock index_block(last_id + 1000000, std::move(page), true);
+        auto [address, write_time] = place_index_block(tape, index_block, anchor);
+        index_pages.push_back(address);
+        time += write_time;
+    }
+    page_stats.pages = index_pages.size();
+    open_entries.clear();
+    return time;
+}
+
+double FixedIntervalIndexStrategy::load_index(TapeDevice& tape) {
+    size_t original_pos = tape.get_current_position();
+    std::vector<IndexPageCodec::Entry> entries;
+    entries.reserve(page_stats.entries + open_entries.size());
+    double time = 0.0;
+    double decode_ns = 0.0;
+    for (const BlockAddress& address : index_pages) {
+        auto [page, read_time] = read_index_block(tape, address);
+        time += read_time;
+        if (!page.is_index_block || page.data == nullptr) {
+            throw std::runtime_error("Corrupt fixed-interval index page at " + std::to_string(address.position));
+        }
+        auto start = std::chrono::steady_clock::now();
+        IndexPageCodec::decode(page.data, page.size, entries);
+        decode_ns += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    }
+    page_stats.decode_ns = decode_ns;
+    entries.insert(entries.end(), open_entries.begin(), open_entries.end());
+    index_map->build(std::move(entries));
+    time += tape.seek_to_block(original_pos);
+    return time;
+}
+
+double FixedIntervalIndexStrategy::on_append(TapeDevice& tape, const TapeBlockView& block, size_t position) {
+    if (block.is_index_block) {
+        return 0.0;
+    }
+    index_map->insert(block.block_id, position);
+    return add_data_block(tape, block.block_id, position);
+}
+
+std::pair<size_t, double> FixedIntervalIndexStrategy::find_block(TapeDevice& tape, uint64_t data_id) {
+    auto [target_pos, time] = resolve_position(tape, data_id);
+    if (target_pos == std::string::npos) {
+        return {std::string::npos, time};
+    }
+    
+    auto [pos, read_time] = read_and_verify(tape, target_pos, data_id);
+    return {pos, time + read_time};
+}
+
+std::pair<size_t, double> FixedIntervalIndexStrategy::resolve_position([[maybe_unused]] TapeDevice& tape,
+                                                                       uint64_t data_id) {
+    uint64_t position = 0;
+    if (!index_map->find(data_id, position)) {
+        return {std::string::npos, 0.0};
+    }
+    return {position, 0.0};
+}
+
+template <typename Model, typename Cache, typename Container>
+std::pair<size_t, double> FixedIntervalIndexStrategy::find_block_as(TapeDevice& tape, uint64_t data_id) {
+    // 与find_block相同：resolve_position不产生耗时，read_and_verify读取并核对ID
+    uint64_t position = 0;
+    if (!IndexContainerOps<Container>::find(*index_map, data_id, position)) {
+        return {std::string::npos, 0.0};
+    }
+    double time = tape.seek_to_block_unchecked<Model, Cache>(position);
+    auto [block, read_time] = tape.view_current_block_unchecked<Model, Cache>();
+    time += read_time;
+    if (block.block_id != data_id) {
+        return {std::string::npos, time};
+    }
+    return {position, time};
+}
+
+std::string FixedIntervalIndexStrategy::get_name() const {
+    return "Fixed Interval Index";
+}
+
+std::string FixedIntervalIndexStrategy::get_stats() const {
+    std::stringstream ss;
+    ss << "Interval: " << interval << ", Placement: " << index_placement_name(placement)
+       << ", Index entries: " << index_map->size()
+       << ", Index pages: " << page_stats.pages << " (" << page_stats.bytes << " bytes)"
+       << ", Container: " << index_map->get_name() << " (" << index_map->memory_bytes() << " bytes)"
+       << ", " << index_cache_stats();
+    return ss.str();
+}
+
+size_t FixedIntervalIndexStrategy::memory_bytes() const {
+    return index_map->memory_bytes() + cache_bytes;
+}
+
+// HierarchicalIndexStrategy 实现
+HierarchicalIndexStrategy::HierarchicalIndexStrategy(size_t level1, size_t level2, const std::string& container)
+    : level1_interval(level1), level2_interval(level2),
+      index_map(IndexContainerFactory::create_container(container)) {}
+
+double HierarchicalIndexStrategy::build_index(TapeDevice& tape) {
+    double time = 0.0;
+    size_t original_pos = tape.get_current_position();
+    size_t block_count = tape.get_block_count();
+    
+    level1_blocks.clear();
+    level2_block_count = 0;
+    clear_index_cache();
+    segments.assign(1, {0, 0});
+    ordinal_count = 0;
+    open_level2.clear();
+    open_level1.clear();
+    if (block_count == 0) {
+        index_map->build({});
+        return time;
+    }
+    
+    // 先完整扫描一遍，再写索引块，避免穿插块改变扫描途中的物理位置
+    std::vector<std::pair<uint64_t, size_t>> data_blocks;
+    if (build_threads > 1) {
+        time += scan_data_blocks(tape, block_count, data_blocks);
+    } else {
+        time += tape.seek_to_block(0);
+        for (size_t i = 0; i < block_count; ++i) {
+            auto [block, read_time] = tape.view_current_block();
+            time += read_time;
+            
+            if (!block.is_index_block) {
+                data_blocks.emplace_back(block.block_id, i);
+            }
+            
+            if (i < block_count - 1) {
+                time += tape.move_forward(1);
+            }
+        }
+    }
+    
+    // 二级块：每level2_interval个数据块的位置；一级块：每level1_interval个二级块的位置
+    // 穿插放置时二级块紧跟其描述的数据块，一级块紧跟它的最后一个二级块
+    std::vector<std::pair<uint64_t, uint64_t>> entries;
+    entries.reserve(data_blocks.size());
+    for (const auto& [block_id, position] : data_blocks) {
+        entries.emplace_back(block_id, entries.size());
+        time += add_data_block(tape, position);
+    }
+    time += flush_open_groups(tape);
+    index_map->build(std::move(entries));
+    
+    time += tape.seek_to_block(original_pos);
+    
+    return time;
+}
+
+double HierarchicalIndexStrategy::on_append(TapeDevice& tape, const TapeBlockView& block, size_t position) {
+    if (block.is_index_block) {
+        return 0.0;
+    }
+    if (segments.empty()) {
+        segments.push_back({0, 0});
+    }
+    index_map->insert(block.block_id, ordinal_count);
+    return add_data_block(tape, position);
+}
+
+double HierarchicalIndexStrategy::add_data_block(TapeDevice& tape, size_t position) {
+    ++ordinal_count;
+    last_anchor = position;
+    open_level2.push_back(position);
+    return open_level2.size() == level2_interval ? write_level2(tape) : 0.0;
+}
+
+double HierarchicalIndexStrategy::write_level2(TapeDevice& tape) {
+    std::vector<uint8_t> level2_data(open_level2.size() * sizeof(uint64_t));
+    std::memcpy(level2_data.data(), open_level2.data(), level2_data.size());
+    TapeBlock level2_block(1000000 + level2_block_count, std::move(level2_data), true);
+    auto [level2_address, time] = place_index_block(tape, level2_block, last_anchor);
+    index_region = level2_address.region;
+    open_level1.push_back(level2_address.position);
+    open_level2.clear();
+    ++level2_block_count;
+    
+    if (open_level1.size() == level1_interval) {
+        time += write_level1(tape);
+    }
+    return time;
+}
+
+double HierarchicalIndexStrategy::write_level1(TapeDevice& tape) {
+    std::vector<uint8_t> level1_data(open_level1.size() * sizeof(uint64_t));
+    std::memcpy(level1_data.data(), open_level1.data(), level1_data.size());
+    TapeBlock level1_block(2000000 + level1_blocks.size(), std::move(level1_data), true);
+    auto [level1_address, time] = place_index_block(tape, level1_block, last_anchor);
+    level1_blocks.push_back(level1_address);
+    open_level1.clear();
+    return time;
+}
+
+double HierarchicalIndexStrategy::flush_open_groups(TapeDevice& tape) {
+    double time = 0.0;
+    if (!open_level2.empty()) {
+        time += write_level2(tape);
+    }
+    if (!open_level1.empty()) {
+        time += write_level1(tape);
+    }
+    if (segments.back().first_ordinal != ordinal_count) {
+        segments.push_back({ordinal_count, level1_blocks.size()});
+    }
+    return time;
+}
+
+std::pair<size_t, double> HierarchicalIndexStrategy::find_block(TapeDevice& tape, uint64_t data_id) {
+    auto [target_pos, time] = resolve_position(tape, data_id);
+    if (target_pos == std::string::npos) {
+        return {std::string::npos, time};
+    }
+    
+    auto [pos, read_time] = read_and_verify(tape, target_pos, data_id);
+    return {pos, time + read_time};
+}
+
+std::pair<size_t, double> HierarchicalIndexStrategy::resolve_position(TapeDevice& tape, uint64_t data_id) {
+    uint64_t ordinal = 0;
+    if (!index_map->find(data_id, ordinal)) {
+        return {std::string::npos, 0.0};
+    }
+    
+    return lookup_ordinal(tape, ordinal, nullptr);
+}
+
+void HierarchicalIndexStrategy::resolve_positions(TapeDevice& tape, const std::vector<uint64_t>& data_ids,
+                                                  std::vector<size_t>& positions, std::vector<double>& times) {
+    positions.assign(data_ids.size(), std::string::npos);
+    times.assign(data_ids.size(), 0.0);
+    
+    // 每个索引块在本批次中只读取一次，耗时计入第一个用到它的查询
+    std::unordered_set<uint64_t> loaded;
+    for (size_t i = 0; i < data_ids.size(); ++i) {
+        uint64_t ordinal = 0;
+        if (!index_map->find(data_ids[i], ordinal)) {
+            continue;
+        }
+        std::tie(positions[i], times[i]) = lookup_ordinal(tape, ordinal, &loaded);
+    }
+}
+
+std::pair<size_t, double> HierarchicalIndexStrategy::lookup_ordinal(TapeDevice& tape, uint64_t ordinal,
+                                                                    std::unordered_set<uint64_t>* loaded) {
+    double time = 0.0;
+    auto segment = std::upper_bound(segments.begin(), segments.end(), ordinal,
+                                    [](uint64_t value, const Segment& seg) { return value < seg.first_ordinal; });
+    if (segment == segments.begin() || ordinal >= ordinal_count) {
+        return {std::string::npos, time};
+    }
+    --segment;
+    uint64_t relative = ordinal - segment->first_ordinal;
+    size_t level2_idx = relative / level2_interval;
+    size_t level1_idx = segment->first_level1 + level2_idx / level1_interval;
+    size_t level1_slot = level2_idx % level1_interval;
+    
+    // 一级块按下标、二级块按位置记录是否已读
+    auto first_read = [loaded](uint64_t key) { return loaded == nullptr || loaded->insert(key).second; };
+    
+    uint64_t level2_pos = 0;
+    if (level1_idx < level1_blocks.size()) {
+        level2_pos = read_slot(tape, level1_blocks[level1_idx], level1_slot, first_read(level1_idx << 1), true,
+                               time);
+    } else if (level1_slot < open_level1.size()) {
+        level2_pos = open_level1[level1_slot];
+    } else {
+        return {open_level2.at(relative % level2_interval), time};
+    }
+    
+    BlockAddress level2_address{index_region, level2_pos};
+    uint64_t position = read_slot(tape, level2_address, relative % level2_interval,
+                                  first_read((level2_pos << 1) | 1), false, time);
+    return {position, time};
+}
+
+uint64_t HierarchicalIndexStrategy::read_slot(TapeDevice& tape, const BlockAddress& address, size_t slot,
+                                              bool charge, bool top_level, double& time) {
+    TapeBlockView block;
+    if (charge) {
+        double read_time = 0.0;
+        std::tie(block, read_time) = read_index_block(tape, address, top_level);
+        time += read_time;
+    } else {
+        block = tape.get_store(address.region).view(address.position);
+    }
+    
+    if (!block.is_index_block || block.data == nullptr || block.size < (slot + 1) * sizeof(uint64_t)) {
+        throw std::runtime_error("Corrupt hierarchical index block at " + std::to_string(address.position));
+    }
+    uint64_t value = 0;
+    std::memcpy(&value, block.data + slot * sizeof(uint64_t), sizeof(value));
+    return value;
+}
+
+std::string HierarchicalIndexStrategy::get_name() const {
+    return "Hierarchical Index";
+}
+
+std::string HierarchicalIndexStrategy::get_stats() const {
+    std::stringstream ss;
+    ss << "Level1 interval: " << level1_interval 
+       << ", Level2 interval: " << level2_interval
+       << ", Placement: " << index_placement_name(placement)
+       << ", Index blocks: " << level1_blocks.size() << " + " << level2_block_count
+       << ", Index entries: " << index_map->size()
+       << ", Container: " << index_map->get_name() << " (" << index_map->memory_bytes() << " bytes)"
+       << ", Id map: in memory (full id->ordinal, on-tape blocks hold positions only)"
+       << ", " << index_cache_stats();
+    return ss.str();
+}
+
+size_t HierarchicalIndexStrategy::memory_bytes() const {
+    return index_map->memory_bytes() + cache_bytes;
+}
+
+// BTreeIndexStrategy 实现
+BTreeIndexStrategy::BTreeIndexStrategy(size_t fan_out) : fan_out(fan_out) {}
+
+double BTreeIndexStrategy::build_index(TapeDevice& tape) {
+    double time = 0.0;
+    size_t original_pos = tape.get_current_position();
+    size_t block_count = tape.get_block_count();
+    
+    root_position = std::string::npos;
+    height = 0;
+    node_count = 0;
+    index_bytes = 0;
+    clear_index_cache();
+    if (block_count == 0) {
+        entry_count = 0;
+        return time;
+    }
+    
+    // 顺序扫描全部块收集数据块位置
+    std::vector<std::pair<uint64_t, size_t>> data_blocks;
+    time += scan_data_blocks(tape, block_count, data_blocks);
+    std::vector<std::pair<uint64_t, uint64_t>> entries(data_blocks.begin(), data_blocks.end());
+    sort_unique_entries(entries);
+    entry_count = entries.size();
+    
+    // 每个节点必须放进一个块，块内至少容纳两个条目树才能逐层收缩
+    size_t block_size = tape.get_block_size();
+    size_t max_fan_out = block_size > NODE_HEADER_BYTES ? (block_size - NODE_HEADER_BYTES) / NODE_ENTRY_BYTES : 0;
+    if (max_fan_out < 2) {
+        throw std::invalid_argument("Block size " + std::to_string(block_size) +
+                                    " cannot hold a B+-tree node with two entries");
+    }
+    effective_fan_out = std::max<size_t>(2, fan_out > 0 ? std::min(fan_out, max_fan_out) : max_fan_out);
+    
+    // 自底向上逐层写入，直到只剩根节点
+    if (!entries.empty()) {
+        size_t anchor = block_count - 1;
+        std::vector<std::pair<uint64_t, uint64_t>> level = write_level(tape, entries, true, anchor, time);
+        height = 1;
+        while (level.size() > 1) {
+            level = write_level(tape, level, false, anchor, time);
+            ++height;
+        }
+        root_position = level.front().second;
+    }
+    
+    time += tape.seek_to_block(original_pos);
+    return time;
+}
+
+std::vector<std::pair<uint64_t, uint64_t>> BTreeIndexStrategy::write_level(
+        TapeDevice& tape, const std::vector<std::pair<uint64_t, uint64_t>>& entries, bool leaf, size_t anchor,
+        double& time) {
+    std::vector<std::pair<uint64_t, uint64_t>> parents;
+    for (size_t begin = 0; begin < entries.size(); begin += effective_fan_out) {
+        size_t count = std::min(effective_fan_out, entries.size() - begin);
+        size_t node_bytes = NODE_HEADER_BYTES + count * NODE_ENTRY_BYTES;
+        
+        std::vector<uint8_t> node(node_bytes, 0);
+        node[0] = leaf ? 1 : 0;
+        uint32_t entry_count32 = static_cast<uint32_t>(count);
+        std::memcpy(node.data() + 4, &entry_count32, sizeof(entry_count32));
+        // 条目逐个写出键与值，不依赖pair的内存布局
+        uint8_t* entry = node.data() + NODE_HEADER_BYTES;
+        for (size_t i = begin; i < begin + count; ++i, entry += NODE_ENTRY_BYTES) {
+            uint64_t key = entries[i].first;
+            uint64_t value = entries[i].second;
+            std::memcpy(entry, &key, sizeof(key));
+            std::memcpy(entry + sizeof(uint64_t), &value, sizeof(value));
+        }
+        
+        TapeBlock node_block(NODE_BLOCK_ID_BASE + node_count, std::move(node), true);
+        auto [address, write_time] = place_index_block(tape, node_block, anchor);
+        node_region = address.region;
+        
+        time += write_time;
+        index_bytes += node_bytes;
+        ++node_count;
+        parents.emplace_back(entries[begin].first, address.position);
+    }
+    return parents;
+}
+
+std::pair<size_t, double> BTreeIndexStrategy::find_block(TapeDevice& tape, uint64_t data_id) {
+    auto [target_pos, time] = resolve_position(tape, data_id);
+    if (target_pos == std::string::npos) {
+        return {std::string::npos, time};
+    }
+    
+    auto [pos, read_time] = read_and_verify(tape, target_pos, data_id);
+    return {pos, time + read_time};
+}
+
+std::pair<size_t, double> BTreeIndexStrategy::resolve_position(TapeDevice& tape, uint64_t data_id) {
+    double time = 0.0;
+    size_t node_pos = root_position;
+    
+    while (node_pos != std::string::npos) {
+        auto [node, read_time] = read_index_block(tape, {node_region, node_pos}, node_pos == root_position);
+        time += read_time;
+        
+        if (!node.is_index_block || node.data == nullptr || node.size < NODE_HEADER_BYTES) {
+            throw std::runtime_error("Corrupt B+-tree node at block " + std::to_string(node_pos));
+        }
+        bool leaf = node.data[0] != 0;
+        uint32_t count = 0;
+        std::memcpy(&count, node.data + 4, sizeof(count));
+        if (node.size < NODE_HEADER_BYTES + count * NODE_ENTRY_BYTES) {
+            throw std::runtime_error("Corrupt B+-tree node at block " + std::to_string(node_pos));
+        }
+        
+        // 在节点内二分查找最后一个键<=data_id的条目
+        const uint8_t* entries = node.data + NODE_HEADER_BYTES;
+        auto key_at = [entries](size_t i) {
+            uint64_t key;
+            std::memcpy(&key, entries + i * NODE_ENTRY_BYTES, sizeof(key));
+            return key;
+        };
+        size_t lo = 0, hi = count;
+        while (lo < hi) {
+            size_t mid = (lo + hi) / 2;
+            if (key_at(mid) <= data_id) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        if (lo == 0 || (leaf && key_at(lo - 1) != data_id)) {
+            return {std::string::npos, time};
+        }
+        
+        uint64_t value = 0;
+        std::memcpy(&value, entries + (lo - 1) * NODE_ENTRY_BYTES + sizeof(uint64_t), sizeof(value));
+        if (leaf) {
+            return {value, time};
+        }
+        node_pos = value;
+    }
+    
+    return {std::string::npos, time};
+}
+
+std::string BTreeIndexStrategy::get_name() const {
+    return "B+Tree Index";
+}
+
+std::string BTreeIndexStrategy::get_stats() const {
+    std::stringstream ss;
+    ss << "Fan-out: " << effective_fan_out << ", Placement: " << index_placement_name(placement)
+       << ", Height: " << height
+       << ", Nodes: " << node_count << ", Index entries: " << entry_count
+       << ", Index bytes on tape: " << index_bytes
+       << ", " << index_cache_stats();
+    return ss.str();
+}
+
+// LearnedIndexStrategy 实现
+LearnedIndexStrategy::LearnedIndexStrategy(size_t error) : error(error) {}
+
+std::vector<LearnedIndexStrategy::Segment> LearnedIndexStrategy::fit_segments(
+        const std::vector<std::pair<uint64_t, uint64_t>>& entries, size_t error) {
+    std::vector<Segment> segments;
+    const double bound = static_cast<double>(error);
+    double slope_lo = 0.0;
+    double slope_hi = 0.0;
+    bool open = false;
+    
+    // 收缩锥：每加入一点，把斜率可行区间与该点允许的区间求交，交集为空时结束当前段
+    for (const auto& [key, position] : entries) {
+        if (open) {
+            const Segment& segment = segments.back();
+            double dx = static_cast<double>(key - segment.first_key);
+            double dy = static_cast<double>(position) - static_cast<double>(segment.first_position);
+            double lo = std::max(slope_lo, (dy - bound) / dx);
+            double hi = std::min(slope_hi, (dy + bound) / dx);
+            if (lo <= hi) {
+                slope_lo = lo;
+                slope_hi = hi;
+                continue;
+            }
+            segments.back().slope = std::isfinite(slope_lo) ? (slope_lo + slope_hi) / 2 : 0.0;
+        }
+        segments.push_back({key, position, 0.0});
+        slope_lo = -std::numeric_limits<double>::infinity();
+        slope_hi = std::numeric_limits<double>::infinity();
+        open = true;
+    }
+    if (open) {
+        segments.back().slope = std::isfinite(slope_lo) ? (slope_lo + slope_hi) / 2 : 0.0;
+    }
+    return segments;
+}
+
+double LearnedIndexStrategy::build_index(TapeDevice& tape) {
+    double time = 0.0;
+    size_t original_pos = tape.get_current_position();
+    size_t block_count = tape.get_block_count();
+    
+    page_first_keys.clear();
+    page_addresses.clear();
+    clear_index_cache();
+    segment_count = 0;
+    entry_count = 0;
+    index_bytes = 0;
+    data_end = block_count;
+    if (block_count == 0) {
+        return time;
+    }
+    
+    std::vector<std::pair<uint64_t, size_t>> data_blocks;
+    time += scan_data_blocks(tape, block_count, data_blocks);
+    std::vector<std::pair<uint64_t, uint64_t>> entries(data_blocks.begin(), data_blocks.end());
+    sort_unique_entries(entries);
+    entry_count = entries.size();
+    
+    std::vector<Segment> segments = fit_segments(entries, error);
+    segment_count = segments.size();
+    size_t per_page = (tape.get_block_size() - SEGMENT_HEADER_BYTES) / SEGMENT_BYTES;
+    if (per_page == 0) {
+        throw std::invalid_argument("Block size too small for learned index segments");
+    }
+    
+    // 分段块没有对应的数据区段，穿插放置时全部锚定在最后一个数据块之后
+    for (size_t begin = 0; begin < segments.size(); begin += per_page) {
+        uint32_t count = static_cast<uint32_t>(std::min(per_page, segments.size() - begin));
+        std::vector<uint8_t> page(SEGMENT_HEADER_BYTES + count * SEGMENT_BYTES, 0);
+        std::memcpy(page.data() + 4, &count, sizeof(count));
+        for (uint32_t i = 0; i < count; ++i) {
+            const Segment& segment = segments[begin + i];
+            uint8_t* out = page.data() + SEGMENT_HEADER_BYTES + i * SEGMENT_BYTES;
+            std::memcpy(out, &segment.first_key, sizeof(uint64_t));
+            std::memcpy(out + 8, &segment.first_position, sizeof(uint64_t));
+            std::memcpy(out + 16, &segment.slope, sizeof(double));
+        }
+        index_bytes += page.size();
+        TapeBlock block(SEGMENT_BLOCK_ID_BASE + page_addresses.size(), std::move(page), true);
+        auto [address, write_time] = place_index_block(tape, block, block_count - 1);
+        time += write_time;
+        page_first_keys.push_back(segments[begin].first_key);
+        page_addresses.push_back(address);
+    }
+    
+    time += tape.seek_to_block(original_pos);
+    return time;
+}
+
+std::pair<size_t, double> LearnedIndexStrategy::find_block(TapeDevice& tape, uint64_t data_id) {
+    double time = 0.0;
+    auto page_it = std::upper_bound(page_first_keys.begin(), page_first_keys.end(), data_id);
+    if (page_it == page_first_keys.begin()) {
+        return {std::string::npos, time};
+    }
+    const BlockAddress& address = page_addresses[page_it - page_first_keys.begin() - 1];
+    auto [page, read_time] = read_index_block(tape, address);
+    time += read_time;
+    
+    uint32_t count = 0;
+    if (!page.is_index_block || page.data == nullptr || page.size < SEGMENT_HEADER_BYTES) {
+        throw std::runtime_error("Corrupt learned index block at " + std::to_string(address.position));
+    }
+    std::memcpy(&count, page.data + 4, sizeof(count));
+    if (count == 0 || page.size < SEGMENT_HEADER_BYTES + count * SEGMENT_BYTES) {
+        throw std::runtime_error("Corrupt learned index block at " + std::to_string(address.position));
+    }
+    
+    // 页内二分查找最后一个首键<=data_id的分段
+    const uint8_t* records = page.data + SEGMENT_HEADER_BYTES;
+    auto key_at = [records](size_t i) {
+        uint64_t key;
+        std::memcpy(&key, records + i * SEGMENT_BYTES, sizeof(key));
+        return key;
+    };
+    size_t lo = 0, hi = count;
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if (key_at(mid) <= data_id) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    Segment segment;
+    const uint8_t* record = records + (lo - 1) * SEGMENT_BYTES;
+    std::memcpy(&segment.first_key, record, sizeof(uint64_t));
+    std::memcpy(&segment.first_position, record + 8, sizeof(uint64_t));
+    std::memcpy(&segment.slope, record + 16, sizeof(double));
+    
+    // 预测值取整后误差可能多出半块，窗口两侧各放宽一块
+    double predicted = static_cast<double>(segment.first_position) +
+                       segment.slope * static_cast<double>(data_id - segment.first_key);
+    double last = static_cast<double>(data_end - 1);
+    size_t center = static_cast<size_t>(std::llround(std::clamp(predicted, 0.0, last)));
+    size_t first = center > error + 1 ? center - error - 1 : 0;
+    size_t end = std::min(data_end, center + error + 2);
+    
+    ++window_lookups;
+    time += tape.seek_to_block(first);
+    for (size_t pos = first; pos < end; ++pos) {
+        auto [block, block_time] = tape.view_current_block();
+        time += block_time;
+        ++window_blocks_read;
+        if (!block.is_index_block && block.block_id == data_id) {
+            return {pos, time};
+        }
+        if (pos + 1 < end) {
+            time += tape.move_forward(1);
+        }
+    }
+    return {std::string::npos, time};
+}
+
+std::string LearnedIndexStrategy::get_name() const {
+    return "Learned Index";
+}
+
+std::string LearnedIndexStrategy::get_stats() const {
+    std::stringstream ss;
+    ss << "Error: " << error << ", Placement: " << index_placement_name(placement)
+       << ", Segments: " << segment_count << " in " << page_addresses.size() << " blocks"
+       << ", Index entries: " << entry_count
+       << ", Index bytes on tape: " << index_bytes
+       << ", Avg window blocks: " << average_window_blocks()
+       << ", " << index_cache_stats();
+    return ss.str();
+}
+
+size_t LearnedIndexStrategy::memory_bytes() const {
+    return page_first_keys.capacity() * sizeof(uint64_t) + page_addresses.capacity() * sizeof(BlockAddress) +
+           cache_bytes;
+}
+
+// FilteredIndexStrategy 实现
+FilteredIndexStrategy::FilteredIndexStrategy(std::unique_ptr<IndexStrategy> inner,
+                                             std::unique_ptr<MembershipFilter> filter)
+    : inner(std::move(inner)), filter(std::move(filter)) {
+    if (!this->inner || !this->filter) {
+        throw std::invalid_argument("Filtered strategy requires a strategy and a filter");
+    }
+    stats.name = this->filter->get_name();
+}
+
+double FilteredIndexStrategy::build_index(TapeDevice& tape) {
+    double time = inner->build_index(tape);
+    size_t original_pos = tape.get_current_position();
+    size_t block_count = tape.get_block_count();
+    
+    // 过滤器单独顺序扫描一遍（内部策略可能不扫描磁带，例如无索引策略）
+    std::vector<uint64_t> keys;
+    if (block_count > 0) {
+        std::vector<std::pair<uint64_t, size_t>> data_blocks;
+        time += tape.seek_to_block(0);
+        time += tape.scan_blocks(block_count);
+        collect_data_blocks(tape.get_store(), block_count, build_threads, data_blocks);
+        keys.reserve(data_blocks.size());
+        for (const auto& entry : data_blocks) {
+            keys.push_back(entry.first);
+        }
+        time += tape.seek_to_block(original_pos);
+    }
+    filter->build(keys);
+    stats = FilterStats();
+    stats.name = filter->get_name();
+    return time;
+}
+
+void FilteredIndexStrategy::record(bool passed, size_t position) {
+    if (!passed) {
+        stats.rejected++;
+        return;
+    }
+    stats.passed++;
+    if (position == std::string::npos) {
+        stats.false_positives++;
+    }
+}
+
+std::pair<size_t, double> FilteredIndexStrategy::find_block(TapeDevice& tape, uint64_t data_id) {
+    if (!filter->may_contain(data_id)) {
+        record(false, std::string::npos);
+        return {std::string::npos, 0.0};
+    }
+    auto result = inner->find_block(tape, data_id);
+    record(true, result.first);
+    return result;
+}
+
+std::vector<std::pair<size_t, double>> FilteredIndexStrategy::find_blocks(TapeDevice& tape,
+                                                                          const std::vector<uint64_t>& data_ids,
+                                                                          BatchSchedule schedule,
+                                                                          BatchStats* batch_stats) {
+    // 只把通过过滤器的ID交给内部策略调度
+    std::vector<std::pair<size_t, double>> results(data_ids.size(), {std::string::npos, 0.0});
+    std::vector<uint64_t> passed_ids;
+    std::vector<size_t> passed_index;
+    for (size_t i = 0; i < data_ids.size(); ++i) {
+        if (filter->may_contain(data_ids[i])) {
+            passed_ids.push_back(data_ids[i]);
+            passed_index.push_back(i);
+        } else {
+            record(false, std::string::npos);
+        }
+    }
+    if (passed_ids.empty()) {
+        return results;
+    }
+    auto inner_results = inner->find_blocks(tape, passed_ids, schedule, batch_stats);
+    for (size_t i = 0; i < passed_ids.size(); ++i) {
+        results[passed_index[i]] = inner_results[i];
+        record(true, inner_results[i].first);
+    }
+    return results;
+}
+
+double FilteredIndexStrategy::on_append(TapeDevice& tape, const TapeBlockView& block, size_t position) {
+    double time = inner->on_append(tape, block, position);
+    if (!block.is_index_block) {
+        filter->insert(block.block_id);
+    }
+    return time;
+}
+
+void FilteredIndexStrategy::resolve_positions(TapeDevice& tape, const std::vector<uint64_t>& data_ids,
+                                              std::vector<size_t>& positions, std::vector<double>& times) {
+    positions.assign(data_ids.size(), std::string::npos);
+    times.assign(data_ids.size(), 0.0);
+    std::vector<uint64_t> passed_ids;
+    std::vector<size_t> passed_index;
+    for (size_t i = 0; i < data_ids.size(); ++i) {
+        if (filter->may_contain(data_ids[i])) {
+            passed_ids.push_back(data_ids[i]);
+            passed_index.push_back(i);
+        } else {
+            record(false, std::string::npos);
+        }
+    }
+    std::vector<size_t> inner_positions;
+    std::vector<double> inner_times;
+    inner->resolve_positions(tape, passed_ids, inner_positions, inner_times);
+    for (size_t i = 0; i < passed_ids.size(); ++i) {
+        positions[passed_index[i]] = inner_positions[i];
+        times[passed_index[i]] = inner_times[i];
+        record(true, inner_positions[i]);
+    }
+}
+
+std::string FilteredIndexStrategy::get_name() const {
+    return inner->get_name() + " + " + filter->get_name();
+}
+
+std::string FilteredIndexStrategy::get_stats() const {
+    FilterStats current = get_filter_stats();
+    std::stringstream ss;
+    ss << inner->get_stats() << ", Filter: " << current.name << " (" << current.memory_bytes << " bytes"
+       << ", expected FPP " << current.expected_fpp << ", observed FPP " << current.observed_fpp()
+       << ", rejected " << current.rejected << ", passed " << current.passed << ")";
+    return ss.str();
+}
+
+FilterStats FilteredIndexStrategy::get_filter_stats() const {
+    FilterStats current = stats;
+    current.memory_bytes = filter->memory_bytes();
+    current.expected_fpp = filter->expected_false_positive_rate();
+    return current;
+}
+
+// QueryPipelineFactory 实现
+namespace {
+
+template <typename T>
+struct TypeTag {
+    using type = T;
+};
+
+// 按实际类型（typeid精确匹配，不含派生类）调用f(TypeTag<T>())，没有匹配时返回false
+template <typename Base, typename... Types, typename F>
+bool dispatch_exact_type(const Base& object, F&& f) {
+    return ((typeid(object) == typeid(Types) ? (f(TypeTag<Types>()), true) : false) || ...);
+}
+
+}  // namespace
+
+std::unique_ptr<QueryPipeline> QueryPipelineFactory::create_pipeline(IndexStrategy& strategy, const TapeDevice& tape) {
+    std::unique_ptr<QueryPipeline> pipeline;
+    const BlockCache* cache = tape.get_cache();
+    const std::string suffix = "/" + tape.get_seek_model().get_name() + "/" + (cache ? cache->get_name() : "none");
+    
+    if (typeid(strategy) == typeid(NoIndexStrategy)) {
+        pipeline =
+            std::make_unique<Simulator<NoIndexStrategy>>(static_cast<NoIndexStrategy&>(strategy), "none" + suffix);
+    } else if (typeid(strategy) == typeid(HierarchicalIndexStrategy)) {
+        pipeline = std::make_unique<Simulator<HierarchicalIndexStrategy>>(
+            static_cast<HierarchicalIndexStrategy&>(strategy), "hierarchical" + suffix);
+    } else if (typeid(strategy) == typeid(BTreeIndexStrategy)) {
+        pipeline = std::make_unique<Simulator<BTreeIndexStrategy>>(static_cast<BTreeIndexStrategy&>(strategy),
+                                                                   "btree" + suffix);
+    } else if (typeid(strategy) == typeid(LearnedIndexStrategy)) {
+        pipeline = std::make_unique<Simulator<LearnedIndexStrategy>>(static_cast<LearnedIndexStrategy&>(strategy),
+                                                                     "learned" + suffix);
+    } else if (typeid(strategy) == typeid(FixedIntervalIndexStrategy)) {
+        auto& fixed = static_cast<FixedIntervalIndexStrategy&>(strategy);
+        dispatch_exact_type<SeekModel, LinearSeekModel, PiecewiseSeekModel, SerpentineSeekModel>(
+            tape.get_seek_model(), [&](auto model_tag) {
+                using Model = typename decltype(model_tag)::type;
+                auto with_cache = [&](auto cache_tag) {
+                    using Cache = typename decltype(cache_tag)::type;
+                    dispatch_exact_type<IndexContainer, HashIndexContainer, SortedArrayIndexContainer,
+                                        EytzingerIndexContainer, BTreeIndexContainer>(
+                        fixed.get_container(), [&](auto container_tag) {
+                            using Container = typename decltype(container_tag)::type;
+                            pipeline = std::make_unique<Simulator<FixedIntervalIndexStrategy, Model, Cache, Container>>(
+                                fixed, "fixed/" + fixed.get_container().get_name() + suffix);
+                        });
+                };
+                if (!cache) {
+                    with_cache(TypeTag<NoBlockCache>());
+                } else {
+                    dispatch_exact_type<BlockCache, LruBlockCache, ArcBlockCache>(*cache, with_cache);
+                }
+            });
+    }
+    return pipeline;
+}
+
+// IndexStrategyFactory 实现
+std::unique_ptr<IndexStrategy> IndexStrategyFactory::create_strategy(const std::string& type, 
+                                                                    size_t param1, 
+                                                                    size_t param2,
+                                                                    const std::string& container) {
+    if (type == "none") {
+        return std::make_unique<NoIndexStrategy>();
+    } else if (type == "fixed") {
+        return std::make_unique<FixedIntervalIndexStrategy>(param1 > 0 ? param1 : 10, container);
+    } else if (type == "hierarchical") {
+        return std::make_unique<HierarchicalIndexStrategy>(
+            param1 > 0 ? param1 : 100, 
+            param2 > 0 ? param2 : 10,
+            container
+        );
+    } else if (type == "btree") {
+        return std::make_unique<BTreeIndexStrategy>(param1);
+    } else if (type == "learned") {
+        return std::make_unique<LearnedIndexStrategy>(param1 > 0 ? param1 : 16);
+    } else {
+        throw std::invalid_argument("Unknown index strategy: " + type);
+    }
+}
+
+// WorkStealingPool 实现
+WorkStealingPool::WorkStealingPool(size_t thread_count) {
+    if (thread_count == 0) {
+        thread_count = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (size_t i = 0; i < thread_count; ++i) {
+        queues.push_back(std::make_unique<TaskQueue>());
+    }
+}
+
+bool WorkStealingPool::take_task(size_t worker, std::function<void()>& task) {
+    {
+        TaskQueue& own = *queues[worker];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            return true;
+        }
+    }
+    
+    for (size_t offset = 1; offset < queues.size(); ++offset) {
+        TaskQueue& victim = *queues[(worker + offset) % queues.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingPool::run(std::vector<std::function<void()>> tasks) {
+    // 任务集合在开始前全部分发，运行期间不再新增，因此所有队列为空即可退出
+    for (size_t i = 0; i < tasks.size(); ++i) {
+        queues[i % queues.size()]->tasks.push_back(std::move(tasks[i]));
+    }
+    
+    std::mutex error_mutex;
+    std::exception_ptr first_error;
+    auto worker_loop = [&](size_t worker) {
+        std::function<void()> task;
+        while (take_task(worker, task)) {
+            try {
+                task();
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(error_mutex);
+                if (!first_error) {
+                    first_error = std::current_exception();
+                }
+            }
+        }
+    };
+    
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < queues.size(); ++i) {
+        threads.emplace_back(worker_loop, i);
+    }
+    worker_loop(0);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    
+    if (first_error) {
+        std::rethrow_exception(first_error);
+    }
+}
+
+// ScopedHostTimer 实现
+ScopedHostTimer::ScopedHostTimer(HostTimerStats& stats) : stats(&stats) {
+    TAPE_COUNT(start = thread_cpu_ms());
+}
+
+ScopedHostTimer::~ScopedHostTimer() {
+    TAPE_COUNT(stats->calls++, stats->host_cpu_ms += thread_cpu_ms() - start);
+}
+
+// MetricsExport 实现
+void MetricsExport::add(const std::string& name, const std::string& help, const std::string& type,
+                        const Labels& labels, double value) {
+    samples.push_back({name, help, type, labels, value});
+}
+
+void MetricsExport::add_result(const SimulationResult& result, const Labels& extra_labels) {
+    Labels labels = {{"strategy", result.strategy_name}};
+    labels.insert(labels.end(), extra_labels.begin(), extra_labels.end());
+    add("tape_cache_hits_total", "Device buffer hits during the query phase", "counter", labels, result.cache_hits);
+    add("tape_cache_misses_total", "Device buffer misses during the query phase", "counter", labels,
+        result.cache_misses);
+    add("tape_index_blocks", "Index blocks the strategy wrote to tape", "gauge", labels, result.index_tape_blocks);
+    add("tape_index_bytes", "Index bytes the strategy wrote to tape", "gauge", labels, result.index_tape_bytes);
+    
+    struct Phase {
+        const char* name;
+        const DeviceIoStats* io;
+        const HostTimerStats* timer;
+    };
+    for (const Phase& phase : {Phase{"build", &result.build_io, &result.build_timer},
+                               Phase{"query", &result.io, &result.query_timer}}) {
+        Labels phase_labels = labels;
+        phase_labels.emplace_back("phase", phase.name);
+        const DeviceIoStats& io = *phase.io;
+        const HostTimerStats* timer = phase.timer;
+        add("tape_seeks_total", "Tape repositionings", "counter", phase_labels, io.seeks);
+        add("tape_seek_distance_blocks_total", "Physical blocks travelled by repositionings", "counter",
+            phase_labels, io.seek_distance);
+        add("tape_direction_reversals_total", "Changes of tape motion direction", "counter", phase_labels,
+            io.direction_reversals);
+        add("tape_blocks_read_total", "Blocks delivered to the host", "counter", phase_labels, io.blocks_read);
+        add("tape_bytes_read_total", "Bytes delivered to the host", "counter", phase_labels, io.bytes_read);
+        add("tape_blocks_written_total", "Blocks written to tape", "counter", phase_labels, io.blocks_written);
+        add("tape_bytes_written_total", "Bytes written to tape", "counter", phase_labels, io.bytes_written);
+        add("tape_calls_total", "Timed strategy calls", "counter", phase_labels, timer->calls);
+        add("tape_host_cpu_seconds_total", "Host CPU time spent in strategy calls", "counter", phase_labels,
+            timer->host_cpu_ms / 1e3);
+        add("tape_simulated_seconds_total", "Simulated tape time returned by strategy calls", "counter",
+            phase_labels, timer->simulated_seconds);
+    }
+}
+
+// JSON与Prometheus标签值共用的转义（反斜杠、双引号、换行）
+static std::string escape_metric_string(const std::string& value) {
+    std::string escaped;
+    for (char c : value) {
+        if (c == '\\' || c == '"') {
+            escaped += '\\';
+            escaped += c;
+        } else if (c == '\n') {
+            escaped += "\\n";
+        } else {
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+
+std::string MetricsExport::to_json() const {
+    std::ostringstream out;
+    out << std::setprecision(15);
+    out << "{\"instrumentation\": " << (TAPE_INSTRUMENTATION ? "true" : "false") << ", \"metrics\": [";
+    for (size_t i = 0; i < samples.size(); ++i) {
+        const Sample& sample = samples[i];
+        out << (i > 0 ? ",\n  " : "\n  ") << "{\"name\": \"" << sample.name << "\", \"type\": \"" << sample.type
+            << "\", \"labels\": {";
+        for (size_t j = 0; j < sample.labels.size(); ++j) {
+            out << (j > 0 ? ", " : "") << "\"" << escape_metric_string(sample.labels[j].first) << "\": \""
+                << escape_metric_string(sample.labels[j].second) << "\"";
+        }
+        out << "}, \"value\": " << sample.value << "}";
+    }
+    out << "\n]}\n";
+    return out.str();
+}
+
+std::string MetricsExport::to_prometheus() const {
+    // 按首次出现的顺序分组同名样本
+    std::vector<std::string> names;
+    std::unordered_map<std::string, std::vector<const Sample*>> by_name;
+    for (const Sample& sample : samples) {
+        auto& group = by_name[sample.name];
+        if (group.empty()) {
+            names.push_back(sample.name);
+        }
+        group.push_back(&sample);
+    }
+    
+    std::ostringstream out;
+    out << std::setprecision(15);
+    for (const std::string& name : names) {
+        const auto& group = by_name[name];
+        out << "# HELP " << name << " " << group.front()->help << "\n";
+        out << "# TYPE " << name << " " << group.front()->type << "\n";
+        for (const Sample* sample : group) {
+            out << name;
+            if (!sample->labels.empty()) {
+                out << "{";
+                for (size_t j = 0; j < sample->labels.size(); ++j) {
+                    out << (j > 0 ? "," : "") << sample->labels[j].first << "=\""
+                        << escape_metric_string(sample->labels[j].second) << "\"";
+                }
+                out << "}";
+            }
+            out << " " << sample->value << "\n";
+        }
+    }
+    return out.str();
+}
+
+// LogHistogram 实现
+size_t LogHistogram::bucket_of(uint64_t value) {
+    constexpr uint64_t sub_count = uint64_t(1) << SUB_BUCKET_BITS;
+    if (value < sub_count) {
+        return static_cast<size_t>(value);
+    }
+    // 最高位在第msb位：右移shift位后落在[sub_count/2, sub_count)
+    unsigned msb = 63 - static_cast<unsigned>(__builtin_clzll(value));
+    unsigned shift = msb - (SUB_BUCKET_BITS - 1);
+    constexpr uint64_t half = sub_count / 2;
+    return static_cast<size_t>(sub_count + (shift - 1) * half + ((value >> shift) - half));
+}
+
+uint64_t LogHistogram::bucket_upper(size_t bucket) {
+    constexpr uint64_t sub_count = uint64_t(1) << SUB_BUCKET_BITS;
+    if (bucket < sub_count) {
+        return bucket;
+    }
+    constexpr uint64_t half = sub_count / 2;
+    uint64_t shift = (bucket - sub_count) / half + 1;
+    uint64_t sub = (bucket - sub_count) % half + half;
+    return ((sub + 1) << shift) - 1;
+}
+
+void LogHistogram::record(uint64_t value, uint64_t count) {
+    if (count == 0) {
+        return;
+    }
+    size_t bucket = bucket_of(value);
+    if (bucket >= counts.size()) {
+        counts.resize(bucket + 1, 0);
+    }
+    counts[bucket] += count;
+    total += count;
+    sum += static_cast<long double>(value) * count;
+    min_value = std::min(min_value, value);
+    max_value = std::max(max_value, value);
+}
+
+void LogHistogram::merge(const LogHistogram& other) {
+    if (other.counts.size() > counts.size()) {
+        counts.resize(other.counts.size(), 0);
+    }
+    for (size_t i = 0; i < other.counts.size(); ++i) {
+        counts[i] += other.counts[i];
+    }
+    total += other.total;
+    sum += other.sum;
+    min_value = std::min(min_value, other.min_value);
+    max_value = std::max(max_value, other.max_value);
+}
+
+uint64_t LogHistogram::percentile(double q) const {
+    if (total == 0) {
+        return 0;
+    }
+    q = std::min(1.0, std::max(0.0, q));
+    uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(q * total)));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < counts.size(); ++i) {
+        seen += counts[i];
+        if (seen >= rank) {
+            return std::min(bucket_upper(i), max_value);
+        }
+    }
+    return max_value;
+}
+
+bool LogHistogram::operator==(const LogHistogram& other) const {
+    if (total != other.total || min() != other.min() || max_value != other.max_value) {
+        return false;
+    }
+    size_t n = std::max(counts.size(), other.counts.size());
+    for (size_t i = 0; i < n; ++i) {
+        uint64_t a = i < counts.size() ? counts[i] : 0;
+        uint64_t b = i < other.counts.size() ? other.counts[i] : 0;
+        if (a != b) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// QueryMetrics 实现
+void QueryMetrics::record(double time, uint64_t distance, uint64_t blocks, uint64_t bytes) {
+    latency_ns.record(static_cast<uint64_t>(std::llround(std::max(0.0, time) * 1e9)));
+    seek_distance.record(distance);
+    blocks_read.record(blocks);
+    bytes_read.record(bytes);
+}
+
+void QueryMetrics::merge(const QueryMetrics& other) {
+    latency_ns.merge(other.latency_ns);
+    seek_distance.merge(other.seek_distance);
+    blocks_read.merge(other.blocks_read);
+    bytes_read.merge(other.bytes_read);
+}
+
+// TapeSimulator 实现
+TapeSimulator::TapeSimulator(size_t block_size) : tape_device(block_size) {}
+
+void TapeSimulator::set_strategy(std::unique_ptr<IndexStrategy> strategy) {
+    current_strategy = std::move(strategy);
+}
+
+void TapeSimulator::set_payload_mode(PayloadMode mode) {
+    tape_device.reset();
+    tape_device.set_payload_mode(mode);
+}
+
+void TapeSimulator::save_test_image(const std::string& path, size_t block_count) {
+    generate_test_data(block_count);
+    tape_device.save_image(path);
+}
+
+std::vector<uint64_t> TapeSimulator::sample_stored_ids(size_t count, uint64_t seed) const {
+    std::vector<uint64_t> ids;
+    size_t block_count = tape_device.get_block_count();
+    if (block_count == 0) {
+        return ids;
+    }
+    
+    std::mt19937_64 gen(seed);
+    std::uniform_int_distribution<size_t> pos_dist(0, block_count - 1);
+    while (ids.size() < count) {
+        TapeBlockView block = tape_device.view_block(pos_dist(gen));
+        if (!block.is_index_block) {
+            ids.push_back(block.block_id);
+        }
+    }
+    return ids;
+}
+
+std::vector<uint64_t> TapeSimulator::stored_ids() const {
+    std::vector<uint64_t> ids;
+    for (size_t pos = 0; pos < tape_device.get_block_count(); ++pos) {
+        TapeBlockView block = tape_device.view_block(pos);
+        if (!block.is_index_block) {
+            ids.push_back(block.block_id);
+        }
+    }
+    return ids;
+}
+
+void TapeSimulator::load_image(const std::string& path) {
+    tape_device.reset();
+    tape_device.open_image(path);
+}
+
+void TapeSimulator::generate_test_data(size_t block_count, double data_size_ratio) {
+    tape_device.reset();
+    
+    std::mt19937 gen(static_cast<std::mt19937::result_type>(data_seed));
+    std::mt19937_64 byte_gen(gen());
+    size_t max_size = static_cast<size_t>(tape_device.get_block_size() * data_size_ratio);
+    std::uniform_int_distribution<uint64_t> id_dist(1, 1000000);
+    std::uniform_int_distribution<size_t> size_dist(1, max_size);
+    std::uniform_int_distribution<uint64_t> batch_start_dist(1, 1000000000000ULL);
+    std::uniform_int_distribution<uint64_t> batch_gap_dist(1, 8);
+    uint64_t batch_id = 0;
+    
+    // 按平均块大小预留，避免逐块分配
+    tape_device.reserve(block_count, block_count * (max_size + 1) / 2);
+    
+    bool synthetic = (tape_device.get_payload_mode() == PayloadMode::Synthetic);
+    for (size_t i = 0; i < block_count; ++i) {
+        uint64_t id = 0;
+        if (id_batch_blocks == 0) {
+            id = id_dist(gen);
+        } else {
+            batch_id = (i % id_batch_blocks == 0) ? batch_start_dist(gen) : batch_id + batch_gap_dist(gen);
+            id = batch_id;
+        }
+        size_t data_size = size_dist(gen);
+        
+        // 合成模式只记录长度
+        if (synthetic) {
+            tape_device.write_synthetic_block(id, data_size);
+            continue;
+        }
+        
+        // 直接在设备字节池中生成数据，每次随机数抽取填充8个字节
+        uint8_t* data = tape_device.emplace_block(id, data_size).first;
+        size_t filled = 0;
+        for (; filled + sizeof(uint64_t) <= data_size; filled += sizeof(uint64_t)) {
+            uint64_t word = byte_gen();
+            std::memcpy(data + filled, &word, sizeof(word));
+        }
+        if (filled < data_size) {
+            uint64_t word = byte_gen();
+            std::memcpy(data + filled, &word, data_size - filled);
+        }
+    }
+}
+
+SimulationResult TapeSimulator::run_simulation(size_t block_count, 
+                                              const std::vector<uint64_t>& query_ids,
+                                              bool generate_new_data) {
+    if (!current_strategy) {
+        throw std::runtime_error("No index strategy set");
+    }
+    
+    if (generate_new_data) {
+        generate_test_data(block_count);
+    }
+    
+    SimulationResult result = simulate(tape_device, *current_strategy, query_ids);
+    results.push_back(result);
+    return result;
+}
+
+SimulationResult TapeSimulator::simulate(TapeDevice& tape, IndexStrategy& strategy,
+                                         const std::vector<uint64_t>& query_ids) const {
+    SimulationResult result;
+    result.strategy_name = strategy.get_name();
+    tape.reset_io_stats();
+    {
+        ScopedHostTimer timer(result.build_timer);
+        result.index_build_time = strategy.build_index(tape);
+        timer.add_simulated(result.index_build_time);
+    }
+    result.build_io = tape.get_io_stats();
+    tape.reset_cache_stats();
+    tape.reset_io_stats();
+    
+    result.total_access_time = 0.0;
+    result.total_blocks_accessed = 0;
+    
+    // 记录n次查询：从上次记录以来的寻道和读取量在这n次查询间平均分摊
+    DeviceIoStats last = tape.get_io_stats();
+    auto record = [this, &result, &tape, &last](const std::vector<double>& times) {
+        const DeviceIoStats& now = tape.get_io_stats();
+        uint64_t n = times.size();
+        if (keep_query_times) {
+            result.query_times.insert(result.query_times.end(), times.begin(), times.end());
+        }
+        for (double time : times) {
+            result.total_access_time += time;
+            result.total_blocks_accessed++;
+            result.metrics.record(time, (now.seek_distance - last.seek_distance) / n,
+                                  (now.blocks_read - last.blocks_read) / n, (now.bytes_read - last.bytes_read) / n);
+        }
+        last = now;
+    };
+    
+    if (batch_window == 0) {
+        // 策略、寻道模型与缓冲区组合已特化时经编译期特化的流水线查询，否则走虚函数接口
+        // 每次只交给流水线一个查询，以便逐个查询记录寻道和读取量
+        std::unique_ptr<QueryPipeline> pipeline = QueryPipelineFactory::create_pipeline(strategy, tape);
+        std::vector<uint64_t> single_query(1);
+        std::vector<std::pair<size_t, double>> single_result;
+        for (uint64_t id : query_ids) {
+            double time = 0.0;
+            {
+                ScopedHostTimer timer(result.query_timer);
+                if (pipeline) {
+                    single_query[0] = id;
+                    pipeline->run(tape, single_query, single_result);
+                    time = single_result.front().second;
+                } else {
+                    time = strategy.find_block(tape, id).second;
+                }
+                timer.add_simulated(time);
+            }
+            record({time});
+        }
+    } else {
+        BatchStats stats;
+        stats.rao_time_budget_ms = rao_time_budget_ms;
+        std::vector<double> times;
+        for (size_t begin = 0; begin < query_ids.size(); begin += batch_window) {
+            size_t end = std::min(query_ids.size(), begin + batch_window);
+            std::vector<uint64_t> batch(query_ids.begin() + begin, query_ids.begin() + end);
+            times.clear();
+            {
+                ScopedHostTimer timer(result.query_timer);
+                for (const auto& [pos, time] : strategy.find_blocks(tape, batch, batch_schedule, &stats)) {
+                    times.push_back(time);
+                    timer.add_simulated(time);
+                }
+            }
+            if (!times.empty()) {
+                record(times);
+            }
+        }
+        result.schedule_cpu_ms = stats.schedule_cpu_ms;
+    }
+    result.io = tape.get_io_stats();
+    result.total_seeks = result.io.seeks;
+    
+    if (result.total_blocks_accessed > 0) {
+        result.average_access_time = result.total_access_time / result.total_blocks_accessed;
+    }
+    result.cache_hits = tape.get_cache_stats().hits;
+    result.cache_misses = tape.get_cache_stats().misses;
+    result.index_memory_bytes = strategy.memory_bytes();
+    result.index_tape_blocks = strategy.index_blocks_written();
+    result.index_tape_bytes = strategy.index_bytes_written();
+    result.filter = strategy.get_filter_stats();
+    
+    return result;
+}
+
+std::vector<SimulationResult> TapeSimulator::run_comparison(size_t block_count,
+                                                          const std::vector<uint64_t>& query_ids,
+                                                          const std::vector<std::string>& strategy_types) {
+    generate_test_data(block_count);
+    return run_comparison(query_ids, strategy_types);
+}
+
+std::vector<SimulationResult> TapeSimulator::run_comparison(const std::vector<uint64_t>& query_ids,
+                                                          const std::vector<std::string>& strategy_types) {
+    std::vector<SimulationResult> comparison_results;
+    size_t block_count = tape_device.get_block_count();
+    
+    for (const auto& type : strategy_types) {
+        set_strategy(IndexStrategyFactory::create_strategy(type));
+        comparison_results.push_back(run_simulation(block_count, query_ids, false));
+    }
+    
+    return comparison_results;
+}
+
+std::vector<SimulationResult> TapeSimulator::run_parallel_comparison(const std::vector<uint64_t>& query_ids,
+                                                                    const std::vector<StrategyConfig>& configs,
+                                                                    size_t thread_count) {
+    std::vector<SimulationResult> sweep_results(configs.size());
+    std::vector<std::function<void()>> tasks;
+    tasks.reserve(configs.size());
+    
+    for (size_t i = 0; i < configs.size(); ++i) {
+        tasks.emplace_back([this, &query_ids, &configs, &sweep_results, i]() {
+            TapeDevice cursor = tape_device.create_cursor();
+            auto strategy = IndexStrategyFactory::create_strategy(configs[i].type, configs[i].param1,
+                                                                  configs[i].param2, configs[i].container);
+            strategy->set_index_placement(configs[i].placement);
+            strategy->set_index_cache(configs[i].cache_policy, configs[i].cache_blocks);
+            if (auto filter = MembershipFilterFactory::create_filter(configs[i].filter,
+                                                                     configs[i].filter_bits_per_key)) {
+                strategy = std::make_unique<FilteredIndexStrategy>(std::move(strategy), std::move(filter));
+            }
+            sweep_results[i] = simulate(cursor, *strategy, query_ids);
+        });
+    }
+    
+    WorkStealingPool pool(thread_count);
+    pool.run(std::move(tasks));
+    
+    results.insert(results.end(), sweep_results.begin(), sweep_results.end());
+    return sweep_results;
+}
+
+void TapeSimulator::print_results() const {
+    std::cout << std::left << std::setw(30) << "Strategy"
+              << std::setw(20) << "Index Build Time (s)"
+              << std::setw(20) << "Avg Access Time (s)"
+              << std::setw(20) << "P99 Access Time (s)"
+              << std::setw(15) << "Total Seeks"
+              << std::setw(22) << "Total Access Time (s)"
+              << std::setw(20) << "Index On Tape (KB)" << std::endl;
+    
+    std::cout << std::string(150, '-') << std::endl;
+    
+    for (const auto& res : results) {
+        std::cout << std::left << std::setw(30) << res.strategy_name
+                  << std::setw(20) << std::fixed << std::setprecision(6) << res.index_build_time
+                  << std::setw(20) << std::fixed << std::setprecision(6) << res.average_access_time
+                  << std::setw(20) << std::fixed << std::setprecision(6) << res.metrics.latency_percentile(0.99)
+                  << std::setw(15) << res.total_seeks
+                  << std::setw(22) << std::fixed << std::setprecision(6) << res.total_access_time
+                  << std::setw(20) << std::fixed << std::setprecision(1) << res.index_tape_bytes / 1024.0
+                  << std::endl;
+    }
+}
+
+// TapeLibrary 实现
+const char* mount_policy_name(MountPolicy policy) {
+    switch (policy) {
+        case MountPolicy::FIFO: return "fifo";
+        case MountPolicy::MostQueued: return "most-queued";
+    }
+    return "unknown";
+}
+
+MountPolicy parse_mount_policy(const std::string& name) {
+    if (name == "fifo") return MountPolicy::FIFO;
+    if (name == "most-queued") return MountPolicy::MostQueued;
+    throw std::invalid_argument("Unknown mount policy: " + name);
+}
+
+TapeLibrary::TapeLibrary(const TapeLibraryConfig& library_config, uint64_t seed) : config(library_config) {
+    if (config.drive_count == 0 || config.cartridge_count == 0) {
+        throw std::invalid_argument("Tape library needs at least one drive and one cartridge");
+    }
+    if (config.drive_queue_depths.size() > config.drive_count) {
+        throw std::invalid_argument("More per-drive queue depths than drives");
+    }
+    config.queue_depth = std::max<size_t>(1, config.queue_depth);
+    config.drive_queue_depths.resize(config.drive_count, 0);
+    
+    std::mt19937 gen(static_cast<std::mt19937::result_type>(seed));
+    std::uniform_int_distribution<uint64_t> id_dist(1, 1000000);
+    std::uniform_int_distribution<size_t> size_dist(1, config.block_size / 2);
+    cartridges.resize(config.cartridge_count);
+    for (Cartridge& cartridge : cartridges) {
+        cartridge.tape = TapeDevice(config.block_size);
+        cartridge.tape.set_payload_mode(PayloadMode::Synthetic);
+        for (size_t i = 0; i < config.blocks_per_cartridge; ++i) {
+            uint64_t id = id_dist(gen);
+            cartridge.tape.write_synthetic_block(id, size_dist(gen));
+            cartridge.data_ids.push_back(id);
+        }
+        cartridge.strategy = IndexStrategyFactory::create_strategy(config.strategy);
+        cartridge.strategy->build_index(cartridge.tape);
+        cartridge.tape.seek_to_block(0);
+    }
+}
+
+std::vector<LibraryRequest> TapeLibrary::generate_requests(size_t count, double rate_per_hour,
+                                                           uint64_t seed) const {
+    std::mt19937_64 gen(seed);
+    std::exponential_distribution<double> gap(rate_per_hour / 3600.0);
+    std::uniform_int_distribution<size_t> cartridge_dist(0, cartridges.size() - 1);
+    
+    std::vector<LibraryRequest> requests;
+    requests.reserve(count);
+    double now = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        now += gap(gen);
+        size_t cartridge = cartridge_dist(gen);
+        const std::vector<uint64_t>& ids = cartridges[cartridge].data_ids;
+        uint64_t id = ids[std::uniform_int_distribution<size_t>(0, ids.size() - 1)(gen)];
+        requests.push_back({now, cartridge, id});
+    }
+    return requests;
+}
+
+void TapeLibrary::set_drive_queue_depth(size_t drive, size_t depth) {
+    if (drive >= config.drive_count) {
+        throw std::out_of_range("Drive index out of range");
+    }
+    config.drive_queue_depths[drive] = std::max<size_t>(1, depth);
+}
+
+size_t TapeLibrary::get_drive_queue_depth(size_t drive) const {
+    if (drive >= config.drive_count) {
+        throw std::out_of_range("Drive index out of range");
+    }
+    size_t depth = config.drive_queue_depths[drive];
+    return depth > 0 ? depth : config.queue_depth;
+}
+
+size_t TapeLibrary::choose_cartridge(const std::vector<std::deque<size_t>>& pending,
+                                     const std::vector<LibraryRequest>& requests,
+                                     const std::vector<bool>& mounted) const {
+    size_t best = std::string::npos;
+    for (size_t c = 0; c < pending.size(); ++c) {
+        if (pending[c].empty() || mounted[c]) {
+            continue;
+        }
+        if (best == std::string::npos) {
+            best = c;
+            continue;
+        }
+        double oldest = requests[pending[c].front()].arrival;
+        double best_oldest = requests[pending[best].front()].arrival;
+        bool better = oldest < best_oldest;
+        if (config.mount_policy == MountPolicy::MostQueued) {
+            better = pending[c].size() > pending[best].size() ||
+                     (pending[c].size() == pending[best].size() && better);
+        }
+        if (better) {
+            best = c;
+        }
+    }
+    return best;
+}
+
+struct TapeLibrary::RunState {
+    struct Drive {
+        size_t cartridge = std::string::npos;
+        bool idle = false;  // 等待新请求
+        std::unique_ptr<SimResource> resource;
+    };
+    
+    const std::vector<LibraryRequest>& requests;
+    EventLoop loop;
+    SimResource robot;
+    std::vector<Drive> drives;
+    std::vector<bool> mounted;
+    std::vector<std::deque<size_t>> pending;
+    std::vector<double> latencies;
+    LibraryStats stats;
+    double last_completion = 0.0;
+    
+    RunState(const std::vector<LibraryRequest>& requests, size_t drive_count, size_t cartridge_count)
+        : requests(requests), robot(loop), drives(drive_count), mounted(cartridge_count, false),
+          pending(cartridge_count) {
+        for (Drive& drive : drives) {
+            drive.resource = std::make_unique<SimResource>(loop);
+        }
+    }
+};
+
+void TapeLibrary::drive_step(RunState& state, size_t index) {
+    RunState::Drive& drive = state.drives[index];
+    
+    // 当前磁带有待处理请求：取出一批按LOOK调度执行
+    if (drive.cartridge != std::string::npos && !state.pending[drive.cartridge].empty()) {
+        std::deque<size_t>& queue = state.pending[drive.cartridge];
+        size_t batch_size = std::min(get_drive_queue_depth(index), queue.size());
+        auto batch = std::make_shared<std::vector<size_t>>(queue.begin(), queue.begin() + batch_size);
+        queue.erase(queue.begin(), queue.begin() + batch_size);
+        
+        Cartridge& cartridge = cartridges[drive.cartridge];
+        drive.resource->submit(
+            [this, &state, &cartridge, batch]() {
+                std::vector<uint64_t> ids;
+                for (size_t request : *batch) {
+                    ids.push_back(state.requests[request].block_id);
+                }
+                double batch_time = 0.0;
+                for (const auto& [pos, time] : cartridge.strategy->find_blocks(cartridge.tape, ids)) {
+                    batch_time += time;
+                    state.stats.not_found += (pos == std::string::npos);
+                }
+                return batch_time;
+            },
+            [this, &state, index, batch]() {
+                double now = state.loop.now();
+                for (size_t request : *batch) {
+                    state.latencies.push_back(now - state.requests[request].arrival);
+                }
+                state.last_completion = std::max(state.last_completion, now);
+                drive_step(state, index);
+            });
+        return;
+    }
+    
+    size_t next = choose_cartridge(state.pending, state.requests, state.mounted);
+    if (next == std::string::npos) {
+        drive.idle = true;
+        return;
+    }
+    
+    // 换盘：回卷并退出当前磁带 → 排队等机械手搬运 → 装带
+    size_t previous = drive.cartridge;
+    state.mounted[next] = true;
+    drive.cartridge = next;
+    state.stats.mounts++;
+    auto load = [this, &state, index]() {
+        state.drives[index].resource->submit([this]() { return config.load_time; },
+                                             [this, &state, index]() { drive_step(state, index); });
+    };
+    auto exchange = [this, &state, load]() {
+        state.robot.submit([this]() { return config.robot_exchange_time; }, load);
+    };
+    if (previous == std::string::npos) {
+        exchange();
+        return;
+    }
+    drive.resource->submit(
+        [this, previous]() { return cartridges[previous].tape.seek_to_block(0) + config.unload_time; },
+        [&state, previous, exchange]() {
+            state.mounted[previous] = false;
+            exchange();
+        });
+}
+
+LibraryStats TapeLibrary::run(const std::vector<LibraryRequest>& requests) {
+    if (requests.empty()) {
+        return LibraryStats();
+    }
+    for (Cartridge& cartridge : cartridges) {
+        cartridge.tape.seek_to_block(0);
+    }
+    
+    RunState state(requests, config.drive_count, cartridges.size());
+    double first_arrival = requests.front().arrival;
+    state.last_completion = first_arrival;
+    
+    // 请求到达：放入所在磁带的队列，并唤醒空闲的驱动器
+    for (size_t i = 0; i < requests.size(); ++i) {
+        state.loop.schedule_at(requests[i].arrival, [this, &state, i]() {
+            state.pending[state.requests[i].cartridge].push_back(i);
+            for (size_t d = 0; d < state.drives.size(); ++d) {
+                if (state.drives[d].idle) {
+                    state.drives[d].idle = false;
+                    drive_step(state, d);
+                }
+            }
+        });
+    }
+    for (size_t d = 0; d < state.drives.size(); ++d) {
+        state.drives[d].idle = true;
+    }
+    state.loop.run();
+    
+    if (state.latencies.size() != requests.size()) {
+        throw std::logic_error("Tape library stalled with pending requests");
+    }
+    
+    LibraryStats stats = state.stats;
+    std::vector<double>& latencies = state.latencies;
+    stats.completed = latencies.size();
+    stats.events = state.loop.processed();
+    stats.robot_wait = state.robot.wait_time();
+    stats.makespan = state.last_completion - first_arrival;
+    if (stats.makespan > 0) {
+        stats.queries_per_hour = stats.completed * 3600.0 / stats.makespan;
+        double busy = 0.0;
+        for (const auto& drive : state.drives) {
+            busy += drive.resource->busy_time();
+        }
+        stats.drive_utilization = busy / (stats.makespan * state.drives.size());
+    }
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&latencies](double p) {
+        size_t rank = static_cast<size_t>(std::ceil(p * latencies.size()));
+        return latencies[std::min(latencies.size() - 1, rank > 0 ? rank - 1 : 0)];
+    };
+    double total = 0.0;
+    for (double latency : latencies) {
+        total += latency;
+    }
+    stats.mean_latency = total / latencies.size();
+    stats.p50_latency = percentile(0.50);
+    stats.p95_latency = percentile(0.95);
+    stats.p99_latency = percentile(0.99);
+    stats.max_latency = latencies.back();
+    return stats;
+}
+
+// WorkloadGenerator 实现
+std::vector<uint64_t> WorkloadGenerator::take(size_t count) {
+    std::vector<uint64_t> ids;
+    ids.reserve(count);
+    uint64_t id = 0;
+    while (ids.size() < count && next(id)) {
+        ids.push_back(id);
+    }
+    return ids;
+}
+
+KeySpaceWorkload::KeySpaceWorkload(std::vector<uint64_t> keys, const WorkloadConfig& config)
+    : keys(std::move(keys)), config(config), gen(config.seed) {
+    if (this->keys.empty()) {
+        throw std::invalid_argument("Workload requires a non-empty key space");
+    }
+    if (config.miss_ratio < 0.0 || config.miss_ratio > 1.0) {
+        throw std::invalid_argument("Workload miss ratio must be in [0, 1]");
+    }
+    miss_base = *std::max_element(this->keys.begin(), this->keys.end()) + 1;
+}
+
+bool KeySpaceWorkload::next(uint64_t& block_id) {
+    if (config.miss_ratio > 0.0 && std::uniform_real_distribution<double>(0.0, 1.0)(gen) < config.miss_ratio) {
+        block_id = miss_base + std::uniform_int_distribution<uint64_t>(0, keys.size() - 1)(gen);
+        return true;
+    }
+    block_id = keys[next_position()];
+    return true;
+}
+
+size_t UniformWorkload::next_position() {
+    return std::uniform_int_distribution<size_t>(0, keys.size() - 1)(gen);
+}
+
+ZipfWorkload::ZipfWorkload(std::vector<uint64_t> keys, const WorkloadConfig& config)
+    : KeySpaceWorkload(std::move(keys), config) {
+    if (config.zipf_theta < 0.0 || config.zipf_theta >= 1.0) {
+        throw std::invalid_argument("Zipf theta must be in [0, 1)");
+    }
+    size_t n = this->keys.size();
+    rank_to_position.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        rank_to_position[i] = i;
+    }
+    std::shuffle(rank_to_position.begin(), rank_to_position.end(), gen);
+    
+    double theta = config.zipf_theta;
+    zeta_n = 0.0;
+    for (size_t i = 1; i <= n; ++i) {
+        zeta_n += 1.0 / std::pow(static_cast<double>(i), theta);
+    }
+    double zeta_2 = 1.0 + std::pow(0.5, theta);
+    alpha = 1.0 / (1.0 - theta);
+    eta = (1.0 - std::pow(2.0 / n, 1.0 - theta)) / (1.0 - zeta_2 / zeta_n);
+}
+
+size_t ZipfWorkload::next_position() {
+    size_t n = keys.size();
+    double u = std::uniform_real_distribution<double>(0.0, 1.0)(gen);
+    double uz = u * zeta_n;
+    size_t rank = 0;
+    if (uz < 1.0) {
+        rank = 0;
+    } else if (uz < 1.0 + std::pow(0.5, config.zipf_theta)) {
+        rank = 1;
+    } else {
+        rank = static_cast<size_t>(n * std::pow(eta * u - eta + 1.0, alpha));
+    }
+    return rank_to_position[std::min(rank, n - 1)];
+}
+
+size_t SequentialWorkload::next_position() {
+    if (remaining == 0 || position + 1 >= keys.size()) {
+        position = std::uniform_int_distribution<size_t>(0, keys.size() - 1)(gen);
+        double p = 1.0 / std::max<size_t>(config.mean_run_length, 1);
+        remaining = std::geometric_distribution<size_t>(p)(gen) + 1;
+    } else {
+        position++;
+    }
+    remaining--;
+    return position;
+}
+
+HotspotWorkload::HotspotWorkload(std::vector<uint64_t> keys, const WorkloadConfig& config)
+    : KeySpaceWorkload(std::move(keys), config) {
+    if (config.hot_fraction <= 0.0 || config.hot_fraction > 1.0) {
+        throw std::invalid_argument("Hotspot fraction must be in (0, 1]");
+    }
+    size_t n = this->keys.size();
+    hot_count = std::max<size_t>(1, static_cast<size_t>(n * config.hot_fraction));
+    hot_begin = std::uniform_int_distribution<size_t>(0, n - hot_count)(gen);
+}
+
+size_t HotspotWorkload::next_position() {
+    size_t n = keys.size();
+    bool hot = hot_count == n || std::uniform_real_distribution<double>(0.0, 1.0)(gen) < config.hot_probability;
+    if (hot) {
+        return hot_begin + std::uniform_int_distribution<size_t>(0, hot_count - 1)(gen);
+    }
+    // 热点区之外的位置映射到[0, n - hot_count)
+    size_t cold = std::uniform_int_distribution<size_t>(0, n - hot_count - 1)(gen);
+    return cold < hot_begin ? cold : cold + hot_count;
+}
+
+size_t RecentWorkload::next_position() {
+    size_t n = keys.size();
+    double mean = std::max(1.0, config.recent_fraction * n);
+    double distance = std::exponential_distribution<double>(1.0 / mean)(gen);
+    return n - 1 - std::min(n - 1, static_cast<size_t>(distance));
+}
+
+// TraceReader 实现
+TraceReader::TraceReader(const std::string& path) : in(path, std::ios::binary), path(path) {
+    if (!in) {
+        throw std::runtime_error("Cannot open trace: " + path);
+    }
+    char magic[sizeof(TRACE_MAGIC)] = {};
+    in.read(magic, sizeof(magic));
+    if (in.gcount() == static_cast<std::streamsize>(sizeof(magic)) &&
+        std::memcmp(magic, TRACE_MAGIC, sizeof(magic)) == 0) {
+        binary = true;
+        return;
+    }
+    in.clear();
+    in.seekg(0);
+}
+
+bool TraceReader::next_record(TraceRecord& record) {
+    if (binary) {
+        char bytes[sizeof(double) + sizeof(uint64_t)];
+        in.read(bytes, sizeof(bytes));
+        if (in.gcount() == 0) {
+            return false;
+        }
+        if (in.gcount() != static_cast<std::streamsize>(sizeof(bytes))) {
+            throw std::runtime_error("Truncated trace record in " + path);
+        }
+        std::memcpy(&record.timestamp, bytes, sizeof(double));
+        std::memcpy(&record.block_id, bytes + sizeof(double), sizeof(uint64_t));
+        record_count++;
+        return true;
+    }
+    
+    std::string line;
+    while (std::getline(in, line)) {
+        line_number++;
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        size_t comma = line.find(',');
+        std::string id_field = (comma == std::string::npos) ? line : line.substr(comma + 1);
+        try {
+            // stoull会接受负号（按无符号回绕）并忽略尾部字符，这里要求整个字段都是无符号整数
+            size_t used = 0;
+            size_t digits = id_field.find_first_not_of(" \t");
+            if (digits == std::string::npos || id_field[digits] == '-' || id_field[digits] == '+') {
+                throw std::invalid_argument("block id");
+            }
+            record.block_id = std::stoull(id_field, &used);
+            if (id_field.find_first_not_of(" \t", used) != std::string::npos) {
+                throw std::invalid_argument("block id");
+            }
+            record.timestamp = 0.0;
+            if (comma != std::string::npos) {
+                std::string time_field = line.substr(0, comma);
+                record.timestamp = std::stod(time_field, &used);
+                if (time_field.find_first_not_of(" \t", used) != std::string::npos) {
+                    throw std::invalid_argument("timestamp");
+                }
+            }
+        } catch (const std::logic_error&) {
+            // 首行允许是表头
+            if (line_number == 1) {
+                continue;
+            }
+            throw std::runtime_error("Malformed trace line " + std::to_string(line_number) + " in " + path);
+        }
+        record_count++;
+        return true;
+    }
+    return false;
+}
+
+bool TraceReader::next(uint64_t& block_id) {
+    TraceRecord record;
+    if (!next_record(record)) {
+        return false;
+    }
+    block_id = record.block_id;
+    return true;
+}
+
+void write_trace(const std::string& path, const std::vector<TraceRecord>& records, bool binary) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw std::runtime_error("Cannot create trace: " + path);
+    }
+    if (binary) {
+        out.write(TRACE_MAGIC, sizeof(TRACE_MAGIC));
+        for (const TraceRecord& record : records) {
+            out.write(reinterpret_cast<const char*>(&record.timestamp), sizeof(double));
+            out.write(reinterpret_cast<const char*>(&record.block_id), sizeof(uint64_t));
+        }
+    } else {
+        out << "timestamp,block_id\n";
+        out << std::setprecision(17);
+        for (const TraceRecord& record : records) {
+            out << record.timestamp << "," << record.block_id << "\n";
+        }
+    }
+    if (!out) {
+        throw std::runtime_error("Failed to write trace: " + path);
+    }
+}
+
+// WorkloadFactory 实现
+std::unique_ptr<WorkloadGenerator> WorkloadFactory::create_workload(const std::string& type,
+                                                                    std::vector<uint64_t> keys,
+                                                                    const WorkloadConfig& config) {
+    if (type == "uniform") {
+        return std::make_unique<UniformWorkload>(std::move(keys), config);
+    } else if (type == "zipf") {
+        return std::make_unique<ZipfWorkload>(std::move(keys), config);
+    } else if (type == "sequential") {
+        return std::make_unique<SequentialWorkload>(std::move(keys), config);
+    } else if (type == "hotspot") {
+        return std::make_unique<HotspotWorkload>(std::move(keys), config);
+    } else if (type == "recent") {
+        return std::make_unique<RecentWorkload>(std::move(keys), config);
+    }
+    throw std::invalid_argument("Unknown workload type: " + type);
+}
+
+// 分配计数实现
+#if TAPE_INSTRUMENTATION
+static thread_local AllocationCounts allocation_counts;
+
+// 不内联：避免编译器把free与调用点的operator new配对后误报-Wmismatched-new-delete
+__attribute__((noinline)) void* operator new(std::size_t size) {
+    allocation_counts.allocations++;
+    allocation_counts.bytes += size;
+    if (void* ptr = std::malloc(size > 0 ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+__attribute__((noinline)) void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+__attribute__((noinline)) void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+AllocationCounts thread_allocation_counts() {
+    return allocation_counts;
+}
+#else
+AllocationCounts thread_allocation_counts() {
+    return AllocationCounts();
+}
+#endif
+
+// BenchmarkSuite 实现
+std::string BenchmarkCase::name() const {
+    return strategy + "/" + container + "/" + workload + "/" + std::to_string(block_count);
+}
+
+BenchmarkSuite::BenchmarkSuite(const std::string& scale, size_t repetitions, size_t query_count)
+    : repetitions(std::max<size_t>(repetitions, 1)), query_count(query_count) {
+    std::vector<size_t> sizes;
+    if (scale == "quick") {
+        sizes = {1000, 10000};
+    } else if (scale == "standard") {
+        sizes = {1000, 10000, 100000, 1000000};
+    } else if (scale == "full") {
+        sizes = {1000, 10000, 100000, 1000000, 10000000, 100000000};
+    } else {
+        throw std::invalid_argument("Unknown benchmark scale: " + scale);
+    }
+    
+    for (size_t blocks : sizes) {
+        std::vector<std::pair<std::string, std::string>> strategies;
+        if (blocks <= 10000) {
+            strategies.emplace_back("none", "hash");
+        }
+        for (const std::string container : {"hash", "sorted", "eytzinger", "btree"}) {
+            strategies.emplace_back("fixed", container);
+        }
+        strategies.emplace_back("hierarchical", "hash");
+        strategies.emplace_back("btree", "hash");
+        for (const auto& [strategy, container] : strategies) {
+            for (const std::string workload : {"uniform", "zipf"}) {
+                cases.push_back({blocks, strategy, container, workload});
+            }
+        }
+    }
+}
+
+std::vector<BenchmarkResult> BenchmarkSuite::run() const {
+    using Clock = std::chrono::high_resolution_clock;
+    const size_t MAX_KEYS = 1000000;
+    std::vector<BenchmarkResult> results;
+    
+    size_t i = 0;
+    while (i < cases.size()) {
+        // 同一规模的用例共享一盘合成磁带
+        size_t blocks = cases[i].block_count;
+        TapeSimulator simulator(4096);
+        simulator.set_payload_mode(PayloadMode::Synthetic);
+        simulator.set_data_seed(1);
+        simulator.generate_tape(blocks);
+        
+        // 键空间超过MAX_KEYS时按等间隔抽取，保持键在磁带上的分布
+        std::vector<uint64_t> keys = simulator.stored_ids();
+        if (keys.size() > MAX_KEYS) {
+            size_t stride = keys.size() / MAX_KEYS;
+            for (size_t k = 0; k < MAX_KEYS; ++k) {
+                keys[k] = keys[k * stride];
+            }
+            keys.resize(MAX_KEYS);
+        }
+        std::unordered_map<std::string, std::vector<uint64_t>> queries;
+        
+        while (i < cases.size() && cases[i].block_count == blocks) {
+            // 同一策略与容器的用例共享已构建的索引
+            const BenchmarkCase& first = cases[i];
+            TapeDevice tape = simulator.get_tape().create_cursor();
+            auto strategy = IndexStrategyFactory::create_strategy(first.strategy, 0, 0, first.container);
+            
+            AllocationCounts before = thread_allocation_counts();
+            auto start = Clock::now();
+            strategy->build_index(tape);
+            double build_ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+            uint64_t build_allocations = thread_allocation_counts().allocations - before.allocations;
+            
+            for (; i < cases.size() && cases[i].block_count == blocks && cases[i].strategy == first.strategy &&
+                   cases[i].container == first.container; ++i) {
+                const BenchmarkCase& config = cases[i];
+                auto& ids = queries[config.workload];
+                if (ids.empty()) {
+                    WorkloadConfig workload;
+                    workload.seed = 2;
+                    ids = WorkloadFactory::create_workload(config.workload, keys, workload)->take(query_count);
+                }
+                
+                // 预热一次，再重复repetitions次
+                tape.seek_to_block(0);
+                for (uint64_t id : ids) {
+                    strategy->find_block(tape, id);
+                }
+                std::vector<double> samples;
+                samples.reserve(repetitions);
+                double simulated = 0.0;
+                uint64_t query_allocations = 0;
+                for (size_t rep = 0; rep < repetitions; ++rep) {
+                    tape.seek_to_block(0);
+                    AllocationCounts rep_before = thread_allocation_counts();
+                    auto rep_start = Clock::now();
+                    for (uint64_t id : ids) {
+                        simulated += strategy->find_block(tape, id).second;
+                    }
+                    samples.push_back(std::chrono::duration<double, std::nano>(Clock::now() - rep_start).count() /
+                                      ids.size());
+                    query_allocations += thread_allocation_counts().allocations - rep_before.allocations;
+                }
+                std::sort(samples.begin(), samples.end());
+                
+                BenchmarkResult result;
+                result.config = config;
+                result.build_ns_per_block = build_ns / blocks;
+                result.query_ns_per_op = samples[samples.size() / 2];
+                result.query_ns_per_op_min = samples.front();
+                result.build_allocations = static_cast<double>(build_allocations);
+                result.allocations_per_query = static_cast<double>(query_allocations) / (repetitions * ids.size());
+                result.bytes_per_entry = static_cast<double>(strategy->memory_bytes()) / blocks;
+                result.simulated_access_time = simulated / (repetitions * ids.size());
+                results.push_back(result);
+            }
+        }
+    }
+    return results;
+}
+
+std::string BenchmarkSuite::to_json(const std::string& scale, const std::vector<BenchmarkResult>& results) {
+    std::ostringstream out;
+    out << std::setprecision(12);
+    out << "{\"suite\": \"tape_simulator\", \"scale\": \"" << scale << "\", \"instrumentation\": "
+        << (TAPE_INSTRUMENTATION ? "true" : "false") << ", \"cases\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchmarkResult& r = results[i];
+        out << "  {\"name\": \"" << r.config.name() << "\", \"blocks\": " << r.config.block_count
+            << ", \"strategy\": \"" << r.config.strategy << "\", \"container\": \"" << r.config.container
+            << "\", \"workload\": \"" << r.config.workload << "\", \"build_ns_per_block\": " << r.build_ns_per_block
+            << ", \"query_ns_per_op\": " << r.query_ns_per_op << ", \"query_ns_per_op_min\": "
+            << r.query_ns_per_op_min << ", \"build_allocations\": " << r.build_allocations
+            << ", \"allocations_per_query\": " << r.allocations_per_query << ", \"bytes_per_entry\": "
+            << r.bytes_per_entry << ", \"simulated_access_time\": " << r.simulated_access_time << "}"
+            << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "]}\n";
+    return out.str();
+}
+
+// 从一行JSON中取出"key": 后的字段文本（字符串去掉引号）；不存在时返回空串
+static std::string json_field(const std::string& line, const std::string& key) {
+    std::string pattern = "\"" + key + "\": ";
+    size_t begin = line.find(pattern);
+    if (begin == std::string::npos) {
+        return "";
+    }
+    begin += pattern.size();
+    if (begin < line.size() && line[begin] == '"') {
+        size_t end = line.find('"', begin + 1);
+        return line.substr(begin + 1, end == std::string::npos ? std::string::npos : end - begin - 1);
+    }
+    size_t end = line.find_first_of(",}", begin);
+    return line.substr(begin, end == std::string::npos ? std::string::npos : end - begin);
+}
+
+std::vector<BenchmarkResult> BenchmarkSuite::load_baseline(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) {
+        throw std::runtime_error("Cannot open benchmark baseline: " + path);
+    }
+    std::vector<BenchmarkResult> results;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (json_field(line, "name").empty()) {
+            continue;
+        }
+        try {
+            BenchmarkResult r;
+            r.config.block_count = std::stoull(json_field(line, "blocks"));
+            r.config.strategy = json_field(line, "strategy");
+            r.config.container = json_field(line, "container");
+            r.config.workload = json_field(line, "workload");
+            r.build_ns_per_block = std::stod(json_field(line, "build_ns_per_block"));
+            r.query_ns_per_op = std::stod(json_field(line, "query_ns_per_op"));
+            r.query_ns_per_op_min = std::stod(json_field(line, "query_ns_per_op_min"));
+            r.build_allocations = std::stod(json_field(line, "build_allocations"));
+            r.allocations_per_query = std::stod(json_field(line, "allocations_per_query"));
+            r.bytes_per_entry = std::stod(json_field(line, "bytes_per_entry"));
+            r.simulated_access_time = std::stod(json_field(line, "simulated_access_time"));
+            results.push_back(r);
+        } catch (const std::logic_error&) {
+            throw std::runtime_error("Malformed benchmark baseline entry in " + path + ": " + line);
+        }
+    }
+    return results;
+}
+
+std::vector<BenchmarkComparison> BenchmarkSuite::compare(const std::vector<BenchmarkResult>& baseline,
+                                                         const std::vector<BenchmarkResult>& current,
+                                                         double tolerance) {
+    std::unordered_map<std::string, const BenchmarkResult*> by_name;
+    for (const BenchmarkResult& r : baseline) {
+        by_name[r.config.name()] = &r;
+    }
+    std::vector<BenchmarkComparison> comparisons;
+    for (const BenchmarkResult& r : current) {
+        auto it = by_name.find(r.config.name());
+        if (it == by_name.end()) {
+            continue;
+        }
+        const BenchmarkResult& base = *it->second;
+        BenchmarkComparison c;
+        c.name = r.config.name();
+        // 最小值受调度和缓存抖动的影响最小，用于判断回归
+        c.baseline_ns = base.query_ns_per_op_min;
+        c.current_ns = r.query_ns_per_op_min;
+        c.regressed = c.current_ns > c.baseline_ns * (1.0 + tolerance);
+        double scale = std::max(std::abs(base.simulated_access_time), 1e-12);
+        c.changed = std::abs(r.simulated_access_time - base.simulated_access_time) / scale > 1e-9;
+        comparisons.push_back(c);
+        by_name.erase(it);
+    }
+    for (const BenchmarkResult& base : baseline) {
+        if (by_name.count(base.config.name()) > 0) {
+            BenchmarkComparison c;
+            c.name = base.config.name();
+            c.baseline_ns = base.query_ns_per_op_min;
+            c.missing = true;
+            comparisons.push_back(c);
+        }
+    }
+    return comparisons;
+}
+
+// EventLoop 实现
+void EventLoop::schedule_at(double time, Action action) {
+    if (time < clock) {
+        throw std::invalid_argument("Cannot schedule an event in the past");
+    }
+    events.push({time, next_sequence++, std::move(action)});
+}
+
+void EventLoop::step() {
+    // priority_queue::top为const，移出动作后再弹出
+    Event event = std::move(const_cast<Event&>(events.top()));
+    events.pop();
+    clock = event.time;
+    processed_count++;
+    event.action();
+}
+
+void EventLoop::run() {
+    while (!events.empty()) {
+        step();
+    }
+}
+
+void EventLoop::run_until(double time) {
+    while (!events.empty() && events.top().time <= time) {
+        step();
+    }
+    clock = std::max(clock, time);
+}
+
+// SimResource 实现
+void SimResource::submit(std::function<double()> operation, std::function<void()> done) {
+    waiting.push_back({std::move(operation), std::move(done), loop->now()});
+    if (!active) {
+        start_next();
+    }
+}
+
+void SimResource::start_next() {
+    if (waiting.empty()) {
+        active = false;
+        return;
+    }
+    active = true;
+    Job job = std::move(waiting.front());
+    waiting.pop_front();
+    wait_seconds += loop->now() - job.submitted;
+    
+    double duration = std::max(0.0, job.operation());
+    busy_seconds += duration;
+    loop->schedule_after(duration, [this, done = std::move(job.done)]() {
+        completed_count++;
+        // 先开始下一个排队的操作，再通知完成（完成回调可能继续提交）
+        start_next();
+        if (done) {
+            done();
+        }
+    });
+}
+
+// WritePipeline 实现
+WritePipeline::WritePipeline(TapeDevice& tape, const WritePipelineConfig& config) : tape(tape), config(config) {
+    if (tape.get_payload_mode() != PayloadMode::Synthetic) {
+        throw std::invalid_argument("Write pipeline needs a tape in synthetic payload mode");
+    }
+    if (config.buffer_bytes < tape.get_block_size() || config.host_rate <= 0) {
+        throw std::invalid_argument("Write pipeline needs a buffer of at least one block and a positive host rate");
+    }
+}
+
+void WritePipeline::submit(uint64_t object_id, size_t size) {
+    stats.objects++;
+    stats.payload_bytes += size;
+    host_clock += config.host_object_overhead + size / config.host_rate;
+    
+    size_t block_size = tape.get_block_size();
+    if (!config.coalesce) {
+        // 每个对象单独成记录，超过block_size的对象切成多条记录
+        size_t offset = 0;
+        do {
+            size_t bytes = std::min(block_size, size - offset);
+            stage(object_id, bytes);
+            offset += bytes;
+        } while (offset < size);
+        return;
+    }
+    
+    // 按字节流合并：对象可以跨越记录边界
+    if (!open_has_id) {
+        open_id = object_id;
+        open_has_id = true;
+    }
+    open_bytes += size;
+    while (open_bytes >= block_size) {
+        open_bytes -= block_size;
+        stage(open_id, block_size);
+        open_id = object_id;
+        open_has_id = open_bytes > 0;
+    }
+}
+
+void WritePipeline::close_open_record() {
+    if (open_bytes > 0) {
+        stage(open_id, open_bytes);
+    }
+    open_bytes = 0;
+    open_has_id = false;
+}
+
+void WritePipeline::stage(uint64_t block_id, size_t bytes) {
+    staged.push_back({block_id, bytes, host_clock});
+    staged_bytes += bytes;
+    drain(false);
+    
+    // 缓冲区超出容量：主机等待最早的已调度记录写完
+    while (!in_flight.empty() && in_flight.front().first <= host_clock) {
+        in_flight_bytes -= in_flight.front().second;
+        in_flight.pop_front();
+    }
+    if (staged_bytes + in_flight_bytes > config.buffer_bytes && !staged.empty()) {
+        drain(true);
+    }
+    while (staged_bytes + in_flight_bytes > config.buffer_bytes && !in_flight.empty()) {
+        double done = in_flight.front().first;
+        if (done > host_clock) {
+            stats.host_wait += done - host_clock;
+            host_clock = done;
+        }
+        in_flight_bytes -= in_flight.front().second;
+        in_flight.pop_front();
+    }
+}
+
+void WritePipeline::drain(bool force) {
+    double restart_bytes = config.restart_fill * config.buffer_bytes;
+    while (!staged.empty()) {
+        double start = drive_clock;
+        if (!streaming || staged.front().ready > drive_clock) {
+            // 缓冲区排空：驱动器停带，之后要重新定位
+            if (streaming) {
+                streaming = false;
+                stats.underruns++;
+                stats.backhitch_seconds += config.backhitch_time;
+                drive_clock += config.backhitch_time;
+            }
+            if (!force && staged_bytes < restart_bytes) {
+                return;
+            }
+            // 在最后一条已到达记录成形时起转（之前的记录此时都已在缓冲区中）
+            start = std::max(drive_clock, staged.back().ready);
+            streaming = true;
+        }
+        
+        const StagedRecord record = staged.front();
+        staged.pop_front();
+        staged_bytes -= record.bytes;
+        double time = tape.write_synthetic_block(record.block_id, record.bytes) + config.record_overhead;
+        drive_clock = start + time;
+        stats.drive_busy += time;
+        stats.records++;
+        in_flight.emplace_back(drive_clock, record.bytes);
+        in_flight_bytes += record.bytes;
+    }
+}
+
+void WritePipeline::sync() {
+    close_open_record();
+    drain(true);
+    
+    // 文件标记写在最后一条记录之后；主机等待同步完成，驱动器随后停带重新定位
+    drive_clock = std::max(drive_clock, host_clock) + config.filemark_time;
+    stats.drive_busy += config.filemark_time;
+    stats.filemarks++;
+    filemark_positions.push_back(tape.get_block_count());
+    stats.host_wait += drive_clock - host_clock;
+    host_clock = drive_clock;
+    in_flight.clear();
+    in_flight_bytes = 0;
+    if (streaming) {
+        streaming = false;
+        stats.sync_stops++;
+        stats.backhitch_seconds += config.backhitch_time;
+        drive_clock += config.backhitch_time;
+    }
+}
+
+const WritePipelineStats& WritePipeline::finish() {
+    close_open_record();
+    drain(true);
+    stats.elapsed = std::max(host_clock, drive_clock);
+    return stats;
+}
+
+// ObjectPacker 实现
+ObjectPacker::ObjectPacker(TapeDevice& tape) : tape(tape) {
+    if (tape.get_payload_mode() != PayloadMode::Synthetic) {
+        throw std::invalid_argument("Object packer needs a tape in synthetic payload mode");
+    }
+}
+
+double ObjectPacker::add(uint64_t object_id, size_t size) {
+    if (size > std::numeric_limits<uint32_t>::max()) {
+        throw std::invalid_argument("Object too large to pack: " + std::to_string(size) + " bytes");
+    }
+    // 重复添加同一对象时旧版本仍占着磁带空间，但不再计入对象字节数
+    ObjectExtent extent{positions.size(), static_cast<uint32_t>(open_bytes), static_cast<uint32_t>(size)};
+    auto [it, inserted] = extents.try_emplace(object_id, extent);
+    if (!inserted) {
+        payload_bytes -= it->second.length;
+        superseded_bytes += it->second.length;
+        it->second = extent;
+    }
+    payload_bytes += size;
+    if (!open_has_id) {
+        open_id = object_id;
+        open_has_id = true;
+    }
+    
+    // 对象可以跨越块边界，后续块的块ID仍是该对象
+    double time = 0.0;
+    size_t block_size = tape.get_block_size();
+    open_bytes += size;
+    while (open_bytes >= block_size) {
+        open_bytes -= block_size;
+        time += write_block(block_size);
+        open_id = object_id;
+        open_has_id = open_bytes > 0;
+    }
+    return time;
+}
+
+double ObjectPacker::flush() {
+    double time = open_bytes > 0 ? write_block(open_bytes) : 0.0;
+    open_bytes = 0;
+    open_has_id = false;
+    return time;
+}
+
+double ObjectPacker::write_block(size_t bytes) {
+    positions.push_back(tape.get_block_count());
+    return tape.write_synthetic_block(open_id, bytes);
+}
+
+bool ObjectPacker::locate(uint64_t object_id, ObjectExtent& extent) const {
+    auto it = extents.find(object_id);
+    if (it == extents.end()) {
+        return false;
+    }
+    extent = it->second;
+    return true;
+}
+
+PackedReadStats ObjectPacker::read_objects(TapeDevice& cursor, const std::vector<uint64_t>& object_ids) const {
+    PackedReadStats stats;
+    size_t block_size = cursor.get_block_size();
+    std::vector<size_t> blocks;
+    for (uint64_t id : object_ids) {
+        ObjectExtent extent;
+        if (!locate(id, extent)) {
+            continue;
+        }
+        stats.objects_found++;
+        size_t end = extent.offset + extent.length;
+        size_t last = extent.first_block + (end > 0 ? (end - 1) / block_size : 0);
+        if (extent.length > 0 && last >= positions.size()) {
+            throw std::logic_error("Packed object " + std::to_string(id) + " has not been flushed to tape");
+        }
+        for (size_t block = extent.first_block; extent.length > 0 && block <= last; ++block) {
+            blocks.push_back(positions[block]);
+        }
+    }
+    
+    std::sort(blocks.begin(), blocks.end());
+    blocks.erase(std::unique(blocks.begin(), blocks.end()), blocks.end());
+    for (size_t position : blocks) {
+        stats.time += cursor.seek_to_block(position);
+        stats.time += cursor.view_current_block().second;
+    }
+    stats.blocks_read = blocks.size();
+    return stats;
+}
+
+size_t ObjectPacker::memory_bytes() const {
+    // 与HashIndexContainer相同的估算：节点含键值、next指针与缓存的哈希值，另加桶数组与块位置表
+    size_t node_bytes = sizeof(std::pair<const uint64_t, ObjectExtent>) + 2 * sizeof(void*);
+    return extents.size() * node_bytes + extents.bucket_count() * sizeof(void*) +
+           positions.capacity() * sizeof(size_t);
+}
+
+double ObjectPacker::space_efficiency() const {
+    if (positions.empty()) {
+        return 0.0;
+    }
+    // 已写出的字节流扣除被覆盖的旧版本（旧版本位于未满块时按已写出近似，结果下限为0）
+    size_t written = payload_bytes + superseded_bytes - open_bytes;
+    size_t live = written > superseded_bytes ? written - superseded_bytes : 0;
+    return static_cast<double>(live) / (positions.size() * tape.get_block_size());
+}
+
+// 主程序（默认执行模拟）
+int main(int argc, char**argv) {
+    // 如果有命令行参数 "benchmark"，则执行基准测试模式
+    const std::string mode = (argc > 1) ? argv[1] : "";
+    if (mode == "benchmark") {
+        return run_benchmarks();
+    }
+    
+    // "image-save <path> [block_count] [seed]"：生成可复现的磁带镜像
+    if (mode == "image-save") {
+        return run_image_save(argc, argv);
+    }
+    
+    // "batch [window] [seek_model] [blocks_per_wrap]"：对比批量查询的各种调度方式
+    if (mode == "batch") {
+        return run_batch_comparison(argc, argv);
+    }
+    
+    // "sweep [threads] [max_interval]"：并行扫描策略参数
+    if (mode == "sweep") {
+        return run_parameter_sweep(argc, argv);
+    }
+    
+    // "containers [entries] [lookups]"：比较索引容器的主机查找耗时和内存占用
+    if (mode == "containers") {
+        return run_container_benchmark(argc, argv);
+    }
+
+    // "placement [blocks] [partition_blocks] [threads]"：对比末尾、穿插、索引分区三种索引布局
+    if (mode == "placement") {
+        return run_placement_comparison(argc, argv);
+    }
+
+    // "seek-models [blocks] [blocks_per_wrap]"：在各寻道模型下对比索引策略
+    if (mode == "seek-models") {
+        return run_seek_model_comparison(argc, argv);
+    }
+
+    // "cache [capacity_kb] [read_ahead] [seek_model]"：对比设备缓存策略
+    if (mode == "cache") {
+        return run_cache_comparison(argc, argv);
+    }
+    if (mode == "index-cache") {
+        return run_index_cache_comparison(argc, argv);
+    }
+    if (mode == "incremental") {
+        return run_incremental_benchmark(argc, argv);
+    }
+    if (mode == "parallel-build") {
+        return run_parallel_build_benchmark(argc, argv);
+    }
+    if (mode == "filter") {
+        return run_filter_comparison(argc, argv);
+    }
+    if (mode == "library") {
+        return run_library_simulation(argc, argv);
+    }
+    if (mode == "mm1") {
+        return run_event_engine_check(argc, argv);
+    }
+    if (mode == "workload") {
+        return run_workload_comparison(argc, argv);
+    }
+    if (mode == "trace-save") {
+        return run_trace_save(argc, argv);
+    }
+    if (mode == "latency") {
+        return run_latency_report(argc, argv);
+    }
+    if (mode == "counters") {
+        return run_counter_export(argc, argv);
+    }
+    if (mode == "bench-suite") {
+        return run_benchmark_suite(argc, argv);
+    }
+    if (mode == "specialized") {
+        return run_specialized_comparison(argc, argv);
+    }
+    if (mode == "index-format") {
+        return run_index_format_report(argc, argv);
+    }
+    if (mode == "learned") {
+        return run_learned_comparison(argc, argv);
+    }
+    if (mode == "ingest") {
+        return run_ingest_comparison(argc, argv);
+    }
+    if (mode == "packing") {
+        return run_packing_comparison(argc, argv);
+    }
+
+    // 否则执行常规模拟（参数 "synthetic" 使用合成数据模式，数据块不占用内存；
+    // 参数 "image <path>" 在映射的磁带镜像上运行）
+    try {
+        size_t BLOCK_COUNT = 10000;
+        const size_t QUERY_COUNT = 1000;
+        const size_t BLOCK_SIZE = 4096;
+        const bool synthetic = (mode == "synthetic");
+        const bool from_image = (mode == "image" && argc > 2);
+        
+        TapeSimulator simulator(BLOCK_SIZE);
+        if (synthetic) {
+            simulator.set_payload_mode(PayloadMode::Synthetic);
+        }
+        if (from_image) {
+            auto start = std::chrono::high_resolution_clock::now();
+            simulator.load_image(argv[2]);
+            auto end = std::chrono::high_resolution_clock::now();
+            BLOCK_COUNT = simulator.get_tape().get_block_count();
+            std::cout << "Opened tape image " << argv[2] << " in "
+                      << std::chrono::duration<double, std::milli>(end - start).count() << " ms" << std::endl;
+        }
+        
+        if (!from_image) {
+            simulator.generate_tape(BLOCK_COUNT);
+        }
+        
+        // 固定种子的均匀工作负载；约99%查询磁带上不存在的ID，与在[1, 1000000]内随机取ID时的命中率相当
+        WorkloadConfig workload;
+        workload.seed = 2;
+        workload.miss_ratio = 0.99;
+        std::vector<uint64_t> queries =
+            WorkloadFactory::create_workload("uniform", simulator.stored_ids(), workload)->take(QUERY_COUNT);
+        
+        std::vector<std::string> strategies = {"none", "fixed", "hierarchical", "btree"};
+        
+        std::cout << "Starting tape storage simulation with " << BLOCK_COUNT 
+                  << " blocks and " << QUERY_COUNT << " queries"
+                  << (synthetic ? " (synthetic payloads)" : "") << "..." << std::endl;
+        
+        auto results = simulator.run_comparison(queries, strategies);
+        
+        std::cout << "\nSimulation Results:\n" << std::endl;
+        simulator.print_results();
+        
+        std::cout << "\nPerformance Analysis:" << std::endl;
+        const auto& no_index = results[0];
+        
+        for (size_t i = 1; i < results.size(); ++i) {
+            double speedup = no_index.average_access_time / results[i].average_access_time;
+            std::cout << results[i].strategy_name << " is " 
+                      << std::fixed << std::setprecision(2) << speedup 
+                      << "x faster than no index strategy" << std::endl;
+        }
+        
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    
+    return 0;
+}
+
+// 基准测试入口（供CTest调用）：运行quick规模的基准测试套件并输出JSON
+int run_benchmarks() {
+    try {
+        BenchmarkSuite suite("quick", 3);
+        std::cout << "Scan kernel: " << scan_kernel_name() << "\n";
+        std::cout << "Benchmark Results (JSON):\n";
+        std::cout << BenchmarkSuite::to_json("quick", suite.run());
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Benchmark failed: " << e.what() << std::endl;
+        return 1;
+    }
+}
+
+// 磁带镜像生成入口
+int run_image_save(int argc, char** argv) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " image-save <path> [block_count] [seed]" << std::endl;
+        return 1;
+    }
+    
+    try {
+        const size_t BLOCK_SIZE = 4096;
+        size_t block_count = (argc > 3) ? std::stoull(argv[3]) : 10000;
+        uint64_t seed = (argc > 4) ? std::stoull(argv[4]) : 1;
+        
+        TapeSimulator simulator(BLOCK_SIZE);
+        simulator.set_data_seed(seed);
+        simulator.save_test_image(argv[2], block_count);
+        
+        std::cout << "Saved tape image " << argv[2] << " with " << block_count
+                  << " blocks (seed " << seed << ")" << std::endl;
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
+
+// 批量调度对比入口：在同一磁带上比较各调度方式的总访问时间
+int run_batch_comparison(int argc, char** argv) {
+    try {
+        const size_t BLOCK_COUNT = 10000;
+        const size_t QUERY_COUNT = 1000;
+        const size_t BLOCK_SIZE = 4096;
+        size_t window = (argc > 2) ? std::stoull(argv[2]) : 32;
+        const std::string seek_model = (argc > 3) ? argv[3] : "linear";
+        size_t blocks_per_wrap = (argc > 4) ? std::stoull(argv[4]) : 0;
+        
+        TapeSimulator simulator(BLOCK_SIZE);
+        simulator.set_seek_model(seek_model);
+        simulator.set_geometry(blocks_per_wrap);
+        simulator.set_data_seed(1);
+        simulator.generate_tape(BLOCK_COUNT);
+        std::vector<uint64_t> queries = simulator.sample_stored_ids(QUERY_COUNT, 2);
+        
+        std::vector<std::string> strategies = {"fixed", "hierarchical"};
+        std::vector<BatchSchedule> schedules = {BatchSchedule::FIFO, BatchSchedule::SCAN,
+                                                BatchSchedule::CSCAN, BatchSchedule::LOOK,
+                                                BatchSchedule::WRAP_LOOK, BatchSchedule::RAO};
+        
+        std::cout << "Batch scheduling with window " << window << " (" << BLOCK_COUNT
+                  << " blocks, " << QUERY_COUNT << " queries on stored ids, "
+                  << seek_model << " seek model, " << blocks_per_wrap << " blocks per wrap)\n" << std::endl;
+        std::cout << std::left << std::setw(30) << "Strategy"
+                  << std::setw(12) << "Schedule"
+                  << std::setw(25) << "Total Access Time (s)"
+                  << std::setw(20) << "Savings vs FIFO"
+                  << std::setw(15) << "Saved (s)"
+                  << "Sched CPU (ms)" << std::endl;
+        std::cout << std::string(116, '-') << std::endl;
+        
+        // 每种调度方式使用相同种子重新生成磁带，保证起点一致
+        std::vector<double> fifo_times(strategies.size(), 0.0);
+        for (BatchSchedule schedule : schedules) {
+            simulator.set_batch_mode(window, schedule);
+            auto results = simulator.run_comparison(BLOCK_COUNT, queries, strategies);
+            for (size_t i = 0; i < results.size(); ++i) {
+                if (schedule == BatchSchedule::FIFO) {
+                    fifo_times[i] = results[i].total_access_time;
+                }
+                double savings = fifo_times[i] > 0 ? 1.0 - results[i].total_access_time / fifo_times[i] : 0.0;
+                std::ostringstream savings_text;
+                savings_text << std::fixed << std::setprecision(2) << savings * 100 << "%";
+                std::cout << std::left << std::setw(30) << results[i].strategy_name
+                          << std::setw(12) << batch_schedule_name(schedule)
+                          << std::setw(25) << std::fixed << std::setprecision(6) << results[i].total_access_time
+                          << std::setw(20) << savings_text.str()
+                          << std::setw(15) << std::setprecision(2) << fifo_times[i] - results[i].total_access_time
+                          << std::setprecision(3) << results[i].schedule_cpu_ms << std::endl;
+            }
+        }
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
+
+// 并行参数扫描入口：固定间隔索引的interval取1..max_interval，分层索引取若干组合
+int run_parameter_sweep(int argc, char** argv) {
+    try {
+        const size_t BLOCK_COUNT = 10000;
+        const size_t QUERY_COUNT = 1000;
+        const size_t BLOCK_SIZE = 4096;
+        size_t thread_count = (argc > 2) ? std::stoull(argv[2]) : 0;
+        size_t max_interval = (argc > 3) ? std::stoull(argv[3]) : 100;
+        
+        TapeSimulator simulator(BLOCK_SIZE);
+        simulator.set_data_seed(1);
+        simulator.generate_tape(BLOCK_COUNT);
+        std::vector<uint64_t> queries = simulator.sample_stored_ids(QUERY_COUNT, 2);
+        
+        std::vector<StrategyConfig> configs = {{"none", 0, 0}};
+        for (size_t interval = 1; interval <= max_interval; ++interval) {
+            configs.push_back({"fixed", interval, 0});
+        }
+        for (size_t level1 : {10, 50, 100, 500}) {
+            for (size_t level2 : {5, 10, 20, 50}) {
+                configs.push_back({"hierarchical", level1, level2});
+            }
+        }
+        for (size_t fan_out : {4, 16, 64, 255}) {
+            configs.push_back({"btree", fan_out, 0});
+        }
+        
+        // 0表示按硬件线程数（与WorkStealingPool相同）
+        if (thread_count == 0) {
+            thread_count = std::max(1u, std::thread::hardware_concurrency());
+        }
+        auto start = std::chrono::high_resolution_clock::now();
+        auto results = simulator.run_parallel_comparison(queries, configs, thread_count);
+        auto end = std::chrono::high_resolution_clock::now();
+        
+        std::cout << "Sweep Results:\n";
+        std::cout << "Strategy,Param1,Param2,IndexBuildTime,AvgAccessTime,TotalAccessTime\n";
+        for (size_t i = 0; i < configs.size(); ++i) {
+            std::cout << configs[i].type << "," << configs[i].param1 << "," << configs[i].param2 << ","
+                      << results[i].index_build_time << "," << results[i].average_access_time << ","
+                      << results[i].total_access_time << "\n";
+        }
+        std::cout << "Swept " << configs.size() << " configurations on " << thread_count
+                  << " threads in " << std::chrono::duration<double, std::milli>(end - start).count()
+                  << " ms" << std::endl;
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
+
+// 索引容器基准测试入口：输出每种容器的构建耗时、查找ns/op和每条目字节数
+int run_container_benchmark(int argc, char** argv) {
+    try {
+        size_t entry_count = (argc > 2) ? std::stoull(argv[2]) : 1000000;
+        size_t lookup_count = (argc > 3) ? std::stoull(argv[3]) : 1000000;
+        
+        // 键取自[1, 4 * entry_count]，查找键一半取自已有键
+        std::mt19937_64 gen(1);
+        std::uniform_int_distribution<uint64_t> key_dist(1, 4 * std::max<size_t>(entry_count, 1));
+        std::vector<std::pair<uint64_t, uint64_t>> entries;
+        entries.reserve(entry_count);
+        for (size_t i = 0; i < entry_count; ++i) {
+            entries.emplace_back(key_dist(gen), i);
+        }
+        std::vector<uint64_t> lookups;
+        lookups.reserve(lookup_count);
+        for (size_t i = 0; i < lookup_count; ++i) {
+            lookups.push_back((i % 2 == 0 && entry_count > 0) ? entries[gen() % entry_count].first : key_dist(gen));
+        }
+        
+        std::cout << "Container Benchmark Results:\n";
+        std::cout << "Container,Entries,BuildMs,LookupNsPerOp,BytesPerEntry,Hits\n";
+        for (const std::string type : {"hash", "sorted", "eytzinger", "btree"}) {
+            auto container = IndexContainerFactory::create_container(type);
+            
+            auto build_start = std::chrono::high_resolution_clock::now();
+            container->build(entries);
+            auto build_end = std::chrono::high_resolution_clock::now();
+            
+            size_t hits = 0;
+            auto lookup_start = std::chrono::high_resolution_clock::now();
+            for (uint64_t key : lookups) {
+                uint64_t value = 0;
+                hits += container->find(key, value) ? 1 : 0;
+            }
+            auto lookup_end = std::chrono::high_resolution_clock::now();
+            
+            double build_ms = std::chrono::duration<double, std::milli>(build_end - build_start).count();
+            double lookup_ns = std::chrono::duration<double, std::nano>(lookup_end - lookup_start).count();
+            size_t size = std::max<size_t>(container->size(), 1);
+            std::cout << type << "," << container->size() << "," << build_ms << ","
+                      << (lookups.empty() ? 0.0 : lookup_ns / lookups.size()) << ","
+                      << static_cast<double>(container->memory_bytes()) / size << ","
+                      << hits << "\n";
+        }
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
+
+// 索引布局对比入口：同一磁带上各策略分别把索引放在末尾、穿插在数据中、磁带开头的索引分区
+int run_placement_comparison(int argc, char** argv) {
+    try {
+        const size_t QUERY_COUNT = 1000;
+        const size_t BLOCK_SIZE = 4096;
+        size_t block_count = (argc > 2) ? std::stoull(argv[2]) : 10000;
+        size_t partition_blocks = (argc > 3) ? std::stoull(argv[3]) : 0;
+        size_t thread_count = (argc > 4) ? std::stoull(argv[4]) : 0;
+        if (partition_blocks == 0) {
+            partition_blocks = std::max<size_t>(block_count / 8, 64);
+        }
+        
+        TapeSimulator simulator(BLOCK_SIZE);
+        simulator.set_data_seed(1);
+        simulator.generate_tape(block_count);
+        simulator.format_index_partition(partition_blocks);
+        std::vector<uint64_t> queries = simulator.sample_stored_ids(QUERY_COUNT, 2);
+        
+        // 索引分区按LTFS方式在第一次访问时整体读入内存，其余放置方式逐块读取
+        std::vector<StrategyConfig> configs;
+        for (IndexPlacement placement : {IndexPlacement::End, IndexPlacement::Interleaved,
+                                         IndexPlacement::Partition}) {
+            IndexCachePolicy policy = placement == IndexPlacement::Partition ? IndexCachePolicy::PinAll
+                                                                             : IndexCachePolicy::None;
+            configs.push_back({"fixed", 20, 0, "hash", placement, policy});
+            configs.push_back({"hierarchical", 0, 0, "hash", placement, policy});
+            configs.push_back({"btree", 0, 0, "hash", placement, policy});
+        }
+        
+        auto results = simulator.run_parallel_comparison(queries, configs, thread_count);
+        
+        std::cout << "Placement Results (index partition: " << partition_blocks << " blocks):\n";
+        std::cout << "Strategy,Placement,IndexCache,IndexBuildTime,AvgAccessTime,TotalAccessTime\n";
+        for (size_t i = 0; i < configs.size(); ++i) {
+            std::cout << configs[i].type << "," << index_placement_name(configs[i].placement) << ","
+                      << index_cache_policy_name(configs[i].cache_policy) << ","
+                      << results[i].index_build_time << "," << results[i].average_access_time << ","
+                      << results[i].total_access_time << "\n";
+        }
+        
+        // 逐个核对B+树：每种放置方式下经磁带上的节点解析出的位置都应是ID相同的块，未存储的ID应查不到
+        std::unordered_set<uint64_t> stored(queries.begin(), queries.end());
+        uint64_t absent_id = 0;
+        while (stored.count(absent_id) > 0) {
+            ++absent_id;
+        }
+        size_t verified = 0;
+        size_t checked = 0;
+        for (IndexPlacement placement : {IndexPlacement::End, IndexPlacement::Interleaved,
+                                         IndexPlacement::Partition}) {
+            TapeDevice cursor = simulator.get_tape().create_cursor();
+            BTreeIndexStrategy btree;
+            btree.set_index_placement(placement);
+            btree.build_index(cursor);
+            for (uint64_t id : queries) {
+                size_t position = btree.find_block(cursor, id).first;
+                verified += position != std::string::npos && cursor.view_block(position).block_id == id;
+                ++checked;
+            }
+            verified += btree.find_block(cursor, absent_id).first == std::string::npos;
+            ++checked;
+        }
+        if (verified != checked) {
+            std::cerr << "B+-tree lookup mismatch: " << verified << "/" << checked << std::endl;
+            return 1;
+        }
+        std::cout << "B+-tree lookups verified: " << verified << "/" << checked << "\n";
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
+
+// 寻道模型对比入口：同一磁带在线性、分段、蛇形磁道模型下运行各索引策略，输出相对无索引的加速比
+int run_seek_model_comparison(int argc, char** argv) {
+    try {
+        const size_t QUERY_COUNT = 1000;
+        const size_t BLOCK_SIZE = 4096;
+        size_t block_count = (argc > 2) ? std::stoull(argv[2]) : 10000;
+        size_t blocks_per_wrap = (argc > 3) ? std::stoull(argv[3]) : 0;
+        
+        TapeSimulator simulator(BLOCK_SIZE);
+        simulator.set_geometry(blocks_per_wrap);
+        simulator.set_data_seed(1);
+        simulator.generate_tape(block_count);
+        std::vector<uint64_t> queries = simulator.sample_stored_ids(QUERY_COUNT, 2);
+        
+        std::vector<StrategyConfig> configs = {{"none"}, {"fixed"}, {"hierarchical"}, {"btree"}};
+        
+        std::cout << "Seek Model Results:\n";
+        std::cout << "SeekModel,Strategy,IndexBuildTime,AvgAccessTime,SpeedupVsNoIndex\n";
+        for (const std::string model : {"linear", "piecewise", "serpentine"}) {
+            simulator.set_seek_model(model);
+            auto results = simulator.run_parallel_comparison(queries, configs);
+            for (const auto& result : results) {
+                double speedup = result.average_access_time > 0
+                               ? results[0].average_access_time / result.average_access_time : 0.0;
+                std::cout << model << "," << result.strategy_name << "," << result.index_build_time << ","
+                          << result.average_access_time << "," << speedup << "\n";
+            }
+        }
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
+
+// 设备缓存对比入口：无缓存、LRU、ARC下各索引策略的查询耗时和缓存命中率
+int run_cache_comparison(int argc, char** argv) {
+    try {
+        const size_t BLOCK_COUNT = 10000;
+        const size_t QUERY_COUNT = 1000;
+        const size_t BLOCK_SIZE = 4096;
+        size_t capacity_kb = (argc > 2) ? std::stoull(argv[2]) : 4096;
+        size_t read_ahead = (argc > 3) ? std::stoull(argv[3]) : 8;
+        const std::string seek_model = (argc > 4) ? argv[4] : "piecewise";
+        
+        TapeSimulator simulator(BLOCK_SIZE);
+        simulator.set_seek_model(seek_model);
+        simulator.set_data_seed(1);
+        simulator.generate_tape(BLOCK_COUNT);
+        std::vector<uint64_t> queries = simulator.sample_stored_ids(QUERY_COUNT, 2);
+        
+        std::vector<StrategyConfig> configs = {{"fixed"}, {"hierarchical"}, {"btree"}};
+        
+        std::cout << "Cache Results (" << capacity_kb << " KB buffer, read-ahead " << read_ahead
+                  << " blocks, " << seek_model << " seek model):\n";
+        std::cout << "Policy,Strategy,AvgAccessTime,Hits,Misses,HitRate\n";
+        for (const std::string policy : {"none", "lru", "arc"}) {
+            DeviceCacheConfig config;
+            config.policy = policy;
+            config.capacity_bytes = capacity_kb * 1024;
+            config.read_ahead_blocks = read_ahead;
+            simulator.set_device_cache(config);
+            
+            for (const auto& result : simulator.run_parallel_comparison(queries, configs)) {
+                size_t lookups = result.cache_hits + result.cache_misses;
+                std::cout << policy << "," << result.strategy_name << "," << result.average_access_time << ","
+                          << result.cache_hits << "," << result.cache_misses << ","
+                          << (lookups > 0 ? static_cast<double>(result.cache_hits) / lookups : 0.0) << "\n";
+            }
+        }
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
+
+// 索引块缓存对比入口：同一磁带上各缓存策略的平均访问时间与常驻主机内存
+int run_index_cache_comparison(int argc, char** argv) {
+    try {
+        const size_t QUERY_COUNT = 1000;
+        const size_t BLOCK_SIZE = 4096;
+        size_t block_count = (argc > 2) ? std::stoull(argv[2]) : 10000;
+        size_t lru_blocks = (argc > 3) ? std::stoull(argv[3]) : 64;
+        IndexPlacement placement = parse_index_placement((argc > 4) ? argv[4] : "end");
+        
+        TapeSimulator simulator(BLOCK_SIZE);
+        simulator.set_data_seed(1);
+        simulator.generate_tape(block_count);
+        if (placement == IndexPlacement::Partition) {
+            simulator.format_index_partition(std::max<size_t>(block_count / 8, 64));
+        }
+        std::vector<uint64_t> queries = simulator.sample_stored_ids(QUERY_COUNT, 2);
+        
+        std::vector<StrategyConfig> configs;
+        for (IndexCachePolicy policy : {IndexCachePolicy::None, IndexCachePolicy::PinTop,
+                                        IndexCachePolicy::PinAll, IndexCachePolicy::Lru}) {
+            configs.push_back({"hierarchical", 0, 0, "hash", placement, policy, lru_blocks});
+            configs.push_back({"btree", 0, 0, "hash", placement, policy, lru_blocks});
+        }
+        
+        auto results = simulator.run_parallel_comparison(queries, configs);
+        
+        std::cout << "Index Cache Results (" << index_placement_name(placement) << " placement, LRU "
+                  << lru_blocks << " blocks):\n";
+        std::cout << "Strategy,IndexCache,AvgAccessTime,TotalAccessTime,MemoryBytes\n";
+        for (size_t i = 0; i < configs.size(); ++i) {
+            std::cout << configs[i].type << "," << index_cache_policy_name(configs[i].cache_policy) << ","
+                      << results[i].average_access_time << "," << results[i].total_access_time << ","
+                      << results[i].index_memory_bytes << "\n";
+        }
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
+
+// 增量维护基准入口：磁带持续追加，对比每一步追加时的增量维护开销与此时整盘重建的开销
+int run_incremental_benchmark(int argc, char** argv) {
+    try {
+        const size_t QUERY_COUNT = 1000;
+        const size_t BLOCK_SIZE = 4096;
+        size_t final_blocks = (argc > 2) ? std::stoull(argv[2]) : 100000;
+        size_t steps = std::max<size_t>((argc > 3) ? std::stoull(argv[3]) : 5, 1);
+        const std::string container = (argc > 4) ? argv[4] : "hash";
+        
+        // 转发追加通知并累计增量维护的模拟耗时与主机耗时
+        struct TimedAppendObserver : BlockAppendObserver {
+            IndexStrategy* strategy = nullptr;
+            double sim_time = 0.0;
+            double host_ms = 0.0;
+            double on_append(TapeDevice& tape, const TapeBlockView& block, size_t position) override {
+                auto start = std::chrono::high_resolution_clock::now();
+                double time = strategy->on_append(tape, block, position);
+                auto end = std::chrono::high_resolution_clock::now();
+                host_ms += std::chrono::duration<double, std::milli>(end - start).count();
+                sim_time += time;
+                return time;
+            }
+        };
+        
+        std::cout << "Incremental Results (" << container << " container):\n";
+        std::cout << "Strategy,Blocks,IncrementalSimTime,IncrementalHostMs,RebuildSimTime,RebuildHostMs\n";
+        bool all_verified = true;
+        for (const std::string type : {"fixed", "hierarchical"}) {
+            TapeDevice tape(BLOCK_SIZE);
+            tape.set_payload_mode(PayloadMode::Synthetic);
+            auto strategy = IndexStrategyFactory::create_strategy(type, 0, 0, container);
+            TimedAppendObserver observer;
+            observer.strategy = strategy.get();
+            tape.add_append_observer(&observer);
+            
+            std::mt19937 gen(1);
+            std::uniform_int_distribution<uint64_t> id_dist(1, 1000000);
+            std::uniform_int_distribution<size_t> size_dist(1, BLOCK_SIZE / 2);
+            size_t written = 0;
+            std::unique_ptr<IndexStrategy> rebuilt;
+            TapeDevice cursor = tape.create_cursor();
+            for (size_t step = 1; step <= steps; ++step) {
+                observer.sim_time = 0.0;
+                observer.host_ms = 0.0;
+                size_t target = final_blocks * step / steps;
+                for (; written < target; ++written) {
+                    tape.write_synthetic_block(id_dist(gen), size_dist(gen));
+                }
+                
+                // 对照：在共享同一数据的游标上从零重建
+                cursor = tape.create_cursor();
+                rebuilt = IndexStrategyFactory::create_strategy(type, 0, 0, container);
+                auto start = std::chrono::high_resolution_clock::now();
+                double rebuild_time = rebuilt->build_index(cursor);
+                auto end = std::chrono::high_resolution_clock::now();
+                
+                std::cout << type << "," << written << "," << observer.sim_time << "," << observer.host_ms << ","
+                          << rebuild_time << "," << std::chrono::duration<double, std::milli>(end - start).count()
+                          << "\n";
+            }
+            tape.remove_append_observer(&observer);
+            
+            // 增量索引与重建索引对同一批查询应解析出相同的位置
+            std::mt19937 query_gen(2);
+            std::uniform_int_distribution<size_t> pos_dist(0, tape.get_block_count() - 1);
+            size_t verified = 0, total = 0;
+            while (total < QUERY_COUNT) {
+                TapeBlockView block = tape.get_store().view(pos_dist(query_gen));
+                if (block.is_index_block) {
+                    continue;
+                }
+                ++total;
+                size_t incremental_pos = strategy->find_block(tape, block.block_id).first;
+                size_t rebuilt_pos = rebuilt->find_block(cursor, block.block_id).first;
+                if (incremental_pos != std::string::npos && incremental_pos == rebuilt_pos) {
+                    ++verified;
+                }
+            }
+            std::cout << "Verified " << type << ": " << verified << "/" << total << "\n";
+            all_verified = all_verified && verified == total;
+        }
+        if (all_verified) {
+            std::cout << "All lookups verified\n";
+        }
+        return all_verified ? 0 : 1;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
+
+// 并行构建基准入口：合成数据磁带上对比串行扫描与按区间并行收集的主机耗时，并校验查询结果一致
+int run_parallel_build_benchmark(int argc, char** argv) {
+    try {
+        const size_t QUERY_COUNT = 1000;
+        const size_t BLOCK_SIZE = 4096;
+        size_t block_count = (argc > 2) ? std::stoull(argv[2]) : 2000000;
+        size_t thread_count = (argc > 3) ? std::stoull(argv[3]) : 0;
+        if (thread_count == 0) {
+            thread_count = std::max(1u, std::thread::hardware_concurrency());
+        }
+        
+        TapeSimulator simulator(BLOCK_SIZE);
+        simulator.set_payload_mode(PayloadMode::Synthetic);
+        simulator.set_data_seed(1);
+        simulator.generate_tape(block_count);
+        std::vector<uint64_t> queries = simulator.sample_stored_ids(QUERY_COUNT, 2);
+        
+        std::cout << "Parallel Build Results (" << block_count << " blocks):\n";
+        std::cout << "Strategy,Threads,BuildHostMs,SimBuildTime\n";
+        bool all_match = true;
+        for (const std::string type : {"fixed", "hierarchical", "btree"}) {
+            std::vector<std::vector<size_t>> found;
+            for (size_t threads : {size_t(1), thread_count}) {
+                TapeDevice cursor = simulator.get_tape().create_cursor();
+                auto strategy = IndexStrategyFactory::create_strategy(type);
+                strategy->set_build_threads(threads);
+                
+                auto start = std::chrono::high_resolution_clock::now();
+                double sim_time = strategy->build_index(cursor);
+                auto end = std::chrono::high_resolution_clock::now();
+                std::cout << type << "," << threads << ","
+                          << std::chrono::duration<double, std::milli>(end - start).count() << "," << sim_time
+                          << "\n";
+                
+                std::vector<size_t> positions;
+                for (uint64_t id : queries) {
+                    positions.push_back(strategy->find_block(cursor, id).first);
+                }
+                found.push_back(std::move(positions));
+            }
+            all_match = all_match && found[0] == found[1];
+        }
+        if (all_match) {
+            std::cout << "Parallel build matches serial\n";
+        }
+        return all_match ? 0 : 1;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
+
+// 成员过滤器对比入口：查询ID在1..1000000中均匀抽取（绝大多数未命中），对比各策略加过滤器后的访问时间
+// 另外单独探测过滤器：检查无漏判，并用大量不存在的键测量误判率
+int run_filter_comparison(int argc, char** argv) {
+    try {
+        const size_t QUERY_COUNT = 1000;
+        const size_t PROBE_COUNT = 200000;
+        const size_t BLOCK_SIZE = 4096;
+        size_t block_count = (argc > 2) ? std::stoull(argv[2]) : 10000;
+        size_t bits_per_key = (argc > 3) ? std::stoull(argv[3]) : 10;
+        const std::vector<std::string> filters = {"none", "bloom", "blocked-bloom", "quotient"};
+        
+        TapeSimulator simulator(BLOCK_SIZE);
+        simulator.set_data_seed(1);
+        simulator.generate_tape(block_count);
+        
+        std::mt19937 gen(2);
+        std::uniform_int_distribution<uint64_t> id_dist(1, 1000000);
+        std::vector<uint64_t> queries;
+        for (size_t i = 0; i < QUERY_COUNT; ++i) {
+            queries.push_back(id_dist(gen));
+        }
+        
+        std::vector<StrategyConfig> configs;
+        for (const std::string& filter : filters) {
+            for (const std::string type : {"none", "fixed", "hierarchical", "btree"}) {
+                StrategyConfig config{type};
+                config.filter = filter;
+                config.filter_bits_per_key = bits_per_key;
+                configs.push_back(config);
+            }
+        }
+        auto results = simulator.run_parallel_comparison(queries, configs);
+        
+        std::cout << "Filter Results (" << bits_per_key << " bits/key):\n";
+        std::cout << "Strategy,Filter,FilterBytes,ExpectedFPP,ObservedFPP,IndexBuildTime,AvgAccessTime\n";
+        for (size_t i = 0; i < configs.size(); ++i) {
+            const FilterStats& stats = results[i].filter;
+            std::cout << configs[i].type << "," << configs[i].filter << "," << stats.memory_bytes << ","
+                      << stats.expected_fpp << "," << stats.observed_fpp() << "," << results[i].index_build_time
+                      << "," << results[i].average_access_time << "\n";
+        }
+        
+        // 直接探测：批量构建与逐个插入两种方式都不能漏判
+        std::vector<uint64_t> keys;
+        const TapeBlockStore& store = simulator.get_tape().get_store();
+        for (size_t i = 0; i < store.size(); ++i) {
+            if (!store.is_index(i)) {
+                keys.push_back(store.block_id(i));
+            }
+        }
+        std::unordered_set<uint64_t> key_set(keys.begin(), keys.end());
+        std::mt19937_64 probe_gen(3);
+        
+        std::cout << "Filter,Mode,Bytes,BitsPerKey,ExpectedFPP,ObservedFPP,FalseNegatives\n";
+        bool no_false_negatives = true;
+        for (size_t f = 1; f < filters.size(); ++f) {
+            for (const std::string mode : {"build", "append"}) {
+                // append：先按前一半键构建（已有数据的磁带），再逐个插入后一半（之后追加的块）
+                auto filter = MembershipFilterFactory::create_filter(filters[f], bits_per_key);
+                if (mode == "build") {
+                    filter->build(keys);
+                } else {
+                    filter->build(std::vector<uint64_t>(keys.begin(), keys.begin() + keys.size() / 2));
+                    for (size_t i = keys.size() / 2; i < keys.size(); ++i) {
+                        filter->insert(keys[i]);
+                    }
+                }
+                
+                size_t false_negatives = 0;
+                for (uint64_t key : keys) {
+                    false_negatives += !filter->may_contain(key);
+                }
+                size_t negatives = 0, false_positives = 0;
+                while (negatives < PROBE_COUNT) {
+                    uint64_t key = probe_gen();
+                    if (key_set.count(key)) {
+                        continue;
+                    }
+                    ++negatives;
+                    false_positives += filter->may_contain(key);
+                }
+                no_false_negatives = no_false_negatives && false_negatives == 0;
+                std::cout << filters[f] << "," << mode << "," << filter->memory_bytes() << ","
+                          << 8.0 * filter->memory_bytes() / key_set.size() << ","
+                          << filter->expected_false_positive_rate() << ","
+                          << static_cast<double>(false_positives) / negatives << "," << false_negatives << "\n";
+            }
+        }
+        if (no_false_negatives) {
+            std::cout << "No false negatives\n";
+        }
+        return no_false_negatives ? 0 : 1;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
+
+// 磁带库入口：同一请求序列在不同换盘调度与队列深度下的吞吐量和尾时延
+int run_library_simulation(int argc, char** argv) {
+    try {
+        TapeLibraryConfig config;
+        config.drive_count = (argc > 2) ? std::stoull(argv[2]) : 4;
+        config.cartridge_count = (argc > 3) ? std::stoull(argv[3]) : 16;
+        size_t request_count = (argc > 4) ? std::stoull(argv[4]) : 2000;
+        double rate_per_hour = (argc > 5) ? std::stod(argv[5]) : 300.0;
+        config.strategy = (argc > 6) ? argv[6] : "fixed";
+        
+        TapeLibrary library(config);
+        std::vector<LibraryRequest> requests = library.generate_requests(request_count, rate_per_hour, 2);
+        
+        std::cout << "Library Results (" << config.drive_count << " drives, " << config.cartridge_count
+                  << " cartridges, " << rate_per_hour << " requests/hour offered, " << config.strategy
+                  << " index):\n";
+        std::cout << "Policy,QueueDepth,Completed,QueriesPerHour,MeanLatency,P50,P95,P99,MaxLatency,Mounts,"
+                     "DriveUtilization,RobotWait,Events\n";
+        auto print_row = [](MountPolicy policy, const std::string& depth, const LibraryStats& stats) {
+            std::cout << mount_policy_name(policy) << "," << depth << "," << stats.completed << ","
+                      << stats.queries_per_hour << "," << stats.mean_latency << "," << stats.p50_latency << ","
+                      << stats.p95_latency << "," << stats.p99_latency << "," << stats.max_latency << ","
+                      << stats.mounts << "," << stats.drive_utilization << "," << stats.robot_wait << ","
+                      << stats.events << "\n";
+        };
+        for (MountPolicy policy : {MountPolicy::FIFO, MountPolicy::MostQueued}) {
+            library.set_mount_policy(policy);
+            for (size_t depth : {1, 8, 32}) {
+                library.set_queue_depth(depth);
+                print_row(policy, std::to_string(depth), library.run(requests));
+            }
+            // 混合深度：驱动器0每次只取一个请求（低时延），其余驱动器按32一批
+            library.set_queue_depth(32);
+            library.set_drive_queue_depth(0, 1);
+            print_row(policy, "mixed", library.run(requests));
+        }
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
     }
 }
 
-// TapeSimulator 实现
-TapeSimulator::TapeSimulator(size_t block_size) : tape_device(block_size) {}
-
-void TapeSimulator::set_strategy(std::unique_ptr<IndexStrategy> strategy) {
-    current_strategy = std::move(strategy);
+// 用M/M/1排队验证离散事件引擎：泊松到达、指数服务时间、单个串行资源
+// 稳态平均逗留时间的理论值为 1 / (mu - lambda)
+int run_event_engine_check(int argc, char** argv) {
+    try {
+        double lambda = (argc > 2) ? std::stod(argv[2]) : 0.8;
+        double mu = (argc > 3) ? std::stod(argv[3]) : 1.0;
+        size_t customers = (argc > 4) ? std::stoull(argv[4]) : 200000;
+        if (lambda <= 0 || mu <= lambda || customers == 0) {
+            throw std::invalid_argument("M/M/1 check requires 0 < lambda < mu and at least one customer");
+        }
+        
+        EventLoop loop;
+        SimResource server(loop);
+        std::mt19937_64 rng(7);
+        std::exponential_distribution<double> interarrival(lambda);
+        std::exponential_distribution<double> service(mu);
+        
+        double total_sojourn = 0.0;
+        size_t served = 0;
+        double arrival = 0.0;
+        for (size_t i = 0; i < customers; ++i) {
+            arrival += interarrival(rng);
+            double duration = service(rng);
+            loop.schedule_at(arrival, [&loop, &server, &total_sojourn, &served, arrival, duration]() {
+                server.submit([duration]() { return duration; },
+                              [&loop, &total_sojourn, &served, arrival]() {
+                                  total_sojourn += loop.now() - arrival;
+                                  served++;
+                              });
+            });
+        }
+        loop.run();
+        
+        double observed = total_sojourn / served;
+        double expected = 1.0 / (mu - lambda);
+        double utilization = server.busy_time() / loop.now();
+        double error = std::abs(observed - expected) / expected;
+        std::cout << "M/M/1 Check (lambda=" << lambda << ", mu=" << mu << ", " << served << " customers):\n";
+        std::cout << "MeanSojourn,Theory,RelativeError,Utilization,TheoryUtilization,Events\n";
+        std::cout << observed << "," << expected << "," << error << "," << utilization << ","
+                  << lambda / mu << "," << loop.processed() << "\n";
+        if (error > 0.05) {
+            std::cerr << "M/M/1 mean sojourn deviates from theory by " << error * 100 << "%" << std::endl;
+            return 1;
+        }
+        std::cout << "M/M/1 matches theory\n";
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
 }
 
-void TapeSimulator::generate_test_data(size_t block_count, double data_size_ratio) {
-    tape_device.reset();
-    
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<uint64_t> id_dist(1, 1000000);
-    std::uniform_int_distribution<size_t> size_dist(1, static_cast<size_t>(tape_device.get_block_size() * data_size_ratio));
-    
-    for (size_t i = 0; i < block_count; ++i) {
-        uint64_t id = id_dist(gen);
-        size_t data_size = size_dist(gen);
+// 工作负载对比入口：在同一磁带和设备缓存上，用各生成器（及可选的访问轨迹）的查询对比各策略
+int run_workload_comparison(int argc, char** argv) {
+    try {
+        const size_t BLOCK_COUNT = 10000;
+        const size_t BLOCK_SIZE = 4096;
+        size_t query_count = (argc > 2) ? std::stoull(argv[2]) : 1000;
+        WorkloadConfig workload;
+        workload.zipf_theta = (argc > 3) ? std::stod(argv[3]) : 0.99;
+        workload.seed = 2;
         
-        std::vector<uint8_t> data(data_size);
-        std::generate(data.begin(), data.end(), [&]() { return static_cast<uint8_t>(gen() % 256); });
+        TapeSimulator simulator(BLOCK_SIZE);
+        simulator.set_seek_model("piecewise");
+        simulator.set_data_seed(1);
+        simulator.generate_tape(BLOCK_COUNT);
+        DeviceCacheConfig cache;
+        cache.policy = "lru";
+        cache.capacity_bytes = 4 * 1024 * 1024;
+        cache.read_ahead_blocks = 8;
+        simulator.set_device_cache(cache);
+        
+        std::vector<std::pair<std::string, std::vector<uint64_t>>> workloads;
+        for (const std::string type : {"uniform", "zipf", "sequential", "hotspot", "recent"}) {
+            workloads.emplace_back(type, WorkloadFactory::create_workload(type, simulator.stored_ids(), workload)
+                                             ->take(query_count));
+        }
+        if (argc > 4) {
+            TraceReader trace(argv[4]);
+            workloads.emplace_back("trace", trace.take(query_count));
+            std::cout << "Replayed " << trace.records_read() << " records from " << argv[4] << "\n";
+        }
         
-        tape_device.write_block(TapeBlock(id, data, false));
+        std::vector<StrategyConfig> configs = {{"fixed"}, {"hierarchical"}, {"btree"}};
+        std::cout << "Workload Results (" << BLOCK_COUNT << " blocks, " << query_count << " queries, zipf theta "
+                  << workload.zipf_theta << ", 4096 KB LRU buffer):\n";
+        std::cout << "Workload,Strategy,AvgAccessTime,Seeks,HitRate\n";
+        for (const auto& [name, queries] : workloads) {
+            for (const auto& result : simulator.run_parallel_comparison(queries, configs)) {
+                size_t lookups = result.cache_hits + result.cache_misses;
+                std::cout << name << "," << result.strategy_name << "," << result.average_access_time << ","
+                          << result.total_seeks << ","
+                          << (lookups > 0 ? static_cast<double>(result.cache_hits) / lookups : 0.0) << "\n";
+            }
+        }
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
     }
 }
 
-SimulationResult TapeSimulator::run_simulation(size_t block_count, 
-                                              const std::vector<uint64_t>& query_ids,
-                                              bool generate_new_data) {
-    if (!current_strategy) {
-        throw std::runtime_error("No index strategy set");
-    }
-    
-    if (generate_new_data) {
-        generate_test_data(block_count);
+// 访问轨迹生成入口：在workload对比使用的磁带上按生成器产生查询，以泊松到达时刻写出轨迹文件
+int run_trace_save(int argc, char** argv) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " trace-save <path> [workload] [count] [csv|binary]" << std::endl;
+        return 1;
     }
     
-    SimulationResult result;
-    result.strategy_name = current_strategy->get_name();
-    result.index_build_time = current_strategy->build_index(tape_device);
-    
-    result.total_access_time = 0.0;
-    result.total_seeks = 0;
-    result.total_blocks_accessed = 0;
-    
-    for (uint64_t id : query_ids) {
-        auto [pos, time] = current_strategy->find_block(tape_device, id);
-        result.total_access_time += time;
-        result.total_blocks_accessed++;
+    try {
+        const std::string type = (argc > 3) ? argv[3] : "zipf";
+        size_t count = (argc > 4) ? std::stoull(argv[4]) : 1000;
+        const std::string format = (argc > 5) ? argv[5] : "binary";
+        if (format != "csv" && format != "binary") {
+            throw std::invalid_argument("Unknown trace format: " + format);
+        }
+        
+        TapeSimulator simulator(4096);
+        simulator.set_data_seed(1);
+        simulator.generate_tape(10000);
+        WorkloadConfig workload;
+        workload.seed = 3;
+        std::vector<uint64_t> ids = WorkloadFactory::create_workload(type, simulator.stored_ids(), workload)->take(count);
         
-        if (time > 0) {
-            result.total_seeks++;
+        std::mt19937_64 gen(workload.seed);
+        std::exponential_distribution<double> interarrival(1.0);
+        std::vector<TraceRecord> records;
+        double time = 0.0;
+        for (uint64_t id : ids) {
+            time += interarrival(gen);
+            records.push_back({time, id});
         }
+        write_trace(argv[2], records, format == "binary");
+        
+        // 回读校验
+        TraceReader reader(argv[2]);
+        TraceRecord record;
+        for (const TraceRecord& expected : records) {
+            if (!reader.next_record(record) || record.block_id != expected.block_id ||
+                record.timestamp != expected.timestamp) {
+                throw std::runtime_error("Trace round trip mismatch at record " + std::to_string(reader.records_read()));
+            }
+        }
+        if (reader.next_record(record)) {
+            throw std::runtime_error("Trace contains extra records");
+        }
+        
+        std::cout << "Saved " << format << " trace " << argv[2] << " with " << records.size() << " " << type
+                  << " records" << std::endl;
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
     }
-    
-    if (result.total_blocks_accessed > 0) {
-        result.average_access_time = result.total_access_time / result.total_blocks_accessed;
-    }
-    
-    results.push_back(result);
-    return result;
 }
 
-std::vector<SimulationResult> TapeSimulator::run_comparison(size_t block_count,
-                                                          const std::vector<uint64_t>& query_ids,
-                                                          const std::vector<std::string>& strategy_types) {
-    std::vector<SimulationResult> comparison_results;
-    generate_test_data(block_count);
-    
-    for (const auto& type : strategy_types) {
-        set_strategy(IndexStrategyFactory::create_strategy(type));
-        comparison_results.push_back(run_simulation(block_count, query_ids, false));
+// 尾延迟报告入口：查询流轮流分给shards个工作线程（各自的游标和策略，类比同一磁带镜像的多个读取者），
+// 各线程的直方图合并为每个策略的整体分布
+int run_latency_report(int argc, char** argv) {
+    try {
+        const size_t BLOCK_COUNT = 10000;
+        const size_t BLOCK_SIZE = 4096;
+        size_t query_count = (argc > 2) ? std::stoull(argv[2]) : 4000;
+        const std::string workload_type = (argc > 3) ? argv[3] : "zipf";
+        size_t shards = (argc > 4) ? std::max<size_t>(1, std::stoull(argv[4])) : 4;
+        
+        TapeSimulator simulator(BLOCK_SIZE);
+        simulator.set_seek_model("piecewise");
+        simulator.set_data_seed(1);
+        simulator.set_keep_query_times(true);
+        simulator.generate_tape(BLOCK_COUNT);
+        WorkloadConfig workload;
+        workload.seed = 2;
+        std::vector<uint64_t> queries =
+            WorkloadFactory::create_workload(workload_type, simulator.stored_ids(), workload)->take(query_count);
+        
+        std::vector<std::vector<uint64_t>> shard_queries(shards);
+        for (size_t i = 0; i < queries.size(); ++i) {
+            shard_queries[i % shards].push_back(queries[i]);
+        }
+        
+        std::vector<StrategyConfig> configs = {{"none"}, {"fixed"}, {"hierarchical"}, {"btree"}};
+        std::vector<SimulationResult> merged;
+        std::vector<LogHistogram> reference(configs.size());
+        for (const auto& shard : shard_queries) {
+            std::vector<SimulationResult> results = simulator.run_parallel_comparison(shard, configs);
+            if (merged.empty()) {
+                merged = results;
+            } else {
+                for (size_t i = 0; i < results.size(); ++i) {
+                    merged[i].metrics.merge(results[i].metrics);
+                    merged[i].total_access_time += results[i].total_access_time;
+                    merged[i].total_blocks_accessed += results[i].total_blocks_accessed;
+                    merged[i].total_seeks += results[i].total_seeks;
+                    merged[i].query_times.insert(merged[i].query_times.end(), results[i].query_times.begin(),
+                                                 results[i].query_times.end());
+                }
+            }
+            for (size_t i = 0; i < results.size(); ++i) {
+                reference[i].merge(results[i].metrics.latency_ns);
+            }
+        }
+        
+        std::cout << "Latency Results (" << BLOCK_COUNT << " blocks, " << queries.size() << " " << workload_type
+                  << " queries over " << shards << " workers):\n";
+        std::cout << "Strategy,Mean,P50,P90,P99,P99.9,Max,Seeks,MeanSeekDistance,MeanBlocksRead,MeanBytesRead\n";
+        bool consistent = true;
+        for (size_t i = 0; i < merged.size(); ++i) {
+            const SimulationResult& result = merged[i];
+            const QueryMetrics& metrics = result.metrics;
+            std::cout << result.strategy_name << "," << result.total_access_time / result.total_blocks_accessed << ","
+                      << metrics.latency_percentile(0.50) << "," << metrics.latency_percentile(0.90) << ","
+                      << metrics.latency_percentile(0.99) << "," << metrics.latency_percentile(0.999) << ","
+                      << metrics.latency_ns.max() / 1e9 << "," << result.total_seeks << ","
+                      << metrics.seek_distance.mean() << "," << metrics.blocks_read.mean() << ","
+                      << metrics.bytes_read.mean() << "\n";
+            consistent = consistent && metrics.latency_ns.count() == queries.size() &&
+                         metrics.latency_ns == reference[i];
+        }
+        if (!consistent) {
+            std::cerr << "Merged histograms do not account for every query" << std::endl;
+            return 1;
+        }
+        
+        // 合并后的分位数与全部原始延迟排序后的精确分位数对比：
+        // 直方图返回桶上界，不小于精确值，且相对误差不超过每个二进制量级内子桶宽度 2^-(SUB_BUCKET_BITS-1)
+        const double relative_error = 1.0 / (1u << (LogHistogram::SUB_BUCKET_BITS - 1));
+        double worst_error = 0.0;
+        bool accurate = true;
+        for (const SimulationResult& result : merged) {
+            std::vector<uint64_t> exact_ns;
+            exact_ns.reserve(result.query_times.size());
+            for (double time : result.query_times) {
+                exact_ns.push_back(static_cast<uint64_t>(std::llround(std::max(0.0, time) * 1e9)));
+            }
+            std::sort(exact_ns.begin(), exact_ns.end());
+            accurate = accurate && exact_ns.size() == queries.size();
+            for (double q : {0.50, 0.90, 0.99, 0.999}) {
+                if (exact_ns.empty()) {
+                    break;
+                }
+                size_t rank = std::max<size_t>(1, static_cast<size_t>(std::ceil(q * exact_ns.size())));
+                uint64_t exact = exact_ns[rank - 1];
+                uint64_t estimate = result.metrics.latency_ns.percentile(q);
+                double error = exact > 0 ? static_cast<double>(estimate - exact) / exact : 0.0;
+                worst_error = std::max(worst_error, error);
+                accurate = accurate && estimate >= exact && error <= relative_error;
+            }
+        }
+        if (!accurate) {
+            std::cerr << "Merged percentiles differ from exact percentiles by more than " << relative_error
+                      << " (worst " << worst_error << ")" << std::endl;
+            return 1;
+        }
+        std::cout << "Percentiles within " << relative_error << " of exact (worst " << worst_error << ")\n";
+        std::cout << "Histograms merged across workers\n";
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
     }
-    
-    return comparison_results;
 }
 
-void TapeSimulator::print_results() const {
-    std::cout << std::left << std::setw(30) << "Strategy"
-              << std::setw(20) << "Index Build Time (s)"
-              << std::setw(20) << "Avg Access Time (s)"
-              << std::setw(15) << "Total Seeks"
-              << std::setw(20) << "Total Access Time (s)" << std::endl;
-    
-    std::cout << std::string(110, '-') << std::endl;
-    
-    for (const auto& res : results) {
-        std::cout << std::left << std::setw(30) << res.strategy_name
-                  << std::setw(20) << std::fixed << std::setprecision(6) << res.index_build_time
-                  << std::setw(20) << std::fixed << std::setprecision(6) << res.average_access_time
-                  << std::setw(15) << res.total_seeks
-                  << std::setw(20) << std::fixed << std::setprecision(6) << res.total_access_time << std::endl;
+// 计数器导出入口：在同一磁带上运行各策略，按JSON或Prometheus文本格式输出设备计数器与主机计时
+int run_counter_export(int argc, char** argv) {
+    try {
+        const size_t BLOCK_COUNT = 10000;
+        const size_t BLOCK_SIZE = 4096;
+        const std::string format = (argc > 2) ? argv[2] : "prometheus";
+        size_t query_count = (argc > 3) ? std::stoull(argv[3]) : 1000;
+        if (format != "json" && format != "prometheus") {
+            throw std::invalid_argument("Unknown export format: " + format);
+        }
+        
+        TapeSimulator simulator(BLOCK_SIZE);
+        simulator.set_seek_model("piecewise");
+        simulator.set_data_seed(1);
+        simulator.generate_tape(BLOCK_COUNT);
+        DeviceCacheConfig cache;
+        cache.policy = "lru";
+        cache.capacity_bytes = 4 * 1024 * 1024;
+        cache.read_ahead_blocks = 8;
+        simulator.set_device_cache(cache);
+        WorkloadConfig workload;
+        workload.seed = 2;
+        std::vector<uint64_t> queries =
+            WorkloadFactory::create_workload("zipf", simulator.stored_ids(), workload)->take(query_count);
+        
+        std::vector<StrategyConfig> configs = {{"fixed"}, {"hierarchical"}, {"btree"}};
+        MetricsExport metrics;
+        metrics.add("tape_instrumentation_enabled", "Whether host timers and allocation counters were compiled in", "gauge", {},
+                    TAPE_INSTRUMENTATION);
+        for (const auto& result : simulator.run_parallel_comparison(queries, configs)) {
+            metrics.add_result(result, {{"workload", "zipf"}});
+        }
+        std::cout << (format == "json" ? metrics.to_json() : metrics.to_prometheus());
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
     }
 }
 
-// 主程序（默认执行模拟）
-int main(int argc, char**argv) {
-    // 如果有命令行参数 "benchmark"，则执行基准测试模式
-    if (argc > 1 && std::string(argv[1]) == "benchmark") {
-        return run_benchmarks();
+// 基准测试套件入口：结果写入output（"-"为标准输出）；给出baseline时对比并在回归时返回1
+int run_benchmark_suite(int argc, char** argv) {
+    try {
+        const std::string scale = (argc > 2) ? argv[2] : "standard";
+        const std::string output = (argc > 3) ? argv[3] : "-";
+        const std::string baseline_path = (argc > 4) ? argv[4] : "";
+        double tolerance = (argc > 5) ? std::stod(argv[5]) : 0.25;
+        size_t repetitions = (argc > 6) ? std::stoull(argv[6]) : 5;
+        
+        BenchmarkSuite suite(scale, repetitions);
+        std::cerr << "Running " << suite.get_cases().size() << " benchmark cases (" << scale << ", "
+                  << repetitions << " repetitions)" << std::endl;
+        std::vector<BenchmarkResult> results = suite.run();
+        std::string json = BenchmarkSuite::to_json(scale, results);
+        if (output == "-") {
+            std::cout << json;
+        } else {
+            std::ofstream out(output, std::ios::trunc);
+            if (!out || !(out << json)) {
+                throw std::runtime_error("Cannot write benchmark results: " + output);
+            }
+            std::cout << "Wrote " << results.size() << " benchmark results to " << output << "\n";
+        }
+        
+        if (baseline_path.empty()) {
+            return 0;
+        }
+        auto comparisons = BenchmarkSuite::compare(BenchmarkSuite::load_baseline(baseline_path), results, tolerance);
+        size_t regressions = 0;
+        size_t changes = 0;
+        size_t missing = 0;
+        std::cout << "Case,BaselineMinNsPerOp,CurrentMinNsPerOp,Ratio,Status\n";
+        for (const auto& c : comparisons) {
+            regressions += c.regressed;
+            changes += c.changed;
+            missing += c.missing;
+            std::cout << c.name << "," << c.baseline_ns << "," << c.current_ns << ","
+                      << (c.baseline_ns > 0 ? c.current_ns / c.baseline_ns : 0.0) << ","
+                      << (c.missing ? "MISSING" : c.regressed ? "REGRESSION" : "ok")
+                      << (c.changed ? ",SIMULATION CHANGED" : "") << "\n";
+        }
+        std::cout << "Compared " << comparisons.size() << " cases against " << baseline_path << ": " << regressions
+                  << " regressions, " << changes << " simulation changes, " << missing
+                  << " missing cases (tolerance " << tolerance * 100 << "%)\n";
+        return (regressions > 0 || changes > 0 || missing > 0) ? 1 : 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
     }
+}
 
-    // 否则执行常规模拟
+// 特化流水线对比入口：同一磁带、寻道模型与缓冲区上，比较虚函数路径与编译期特化的Simulator
+// 两条路径各用一个新游标执行同一串查询，逐个核对位置与模拟耗时，再各重复计时取最小值
+int run_specialized_comparison(int argc, char** argv) {
     try {
-        const size_t BLOCK_COUNT = 10000;
-        const size_t QUERY_COUNT = 1000;
         const size_t BLOCK_SIZE = 4096;
+        const size_t REPETITIONS = 5;
+        size_t block_count = (argc > 2) ? std::stoull(argv[2]) : 100000;
+        size_t query_count = (argc > 3) ? std::stoull(argv[3]) : 20000;
+        using Clock = std::chrono::high_resolution_clock;
         
         TapeSimulator simulator(BLOCK_SIZE);
+        simulator.set_payload_mode(PayloadMode::Synthetic);
+        simulator.set_data_seed(1);
+        simulator.generate_tape(block_count);
+        WorkloadConfig workload;
+        workload.seed = 2;
+        std::vector<uint64_t> queries =
+            WorkloadFactory::create_workload("zipf", simulator.stored_ids(), workload)->take(query_count);
         
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::uniform_int_distribution<uint64_t> id_dist(1, 1000000);
+        std::vector<StrategyConfig> configs = {{"fixed", 0, 0, "hash"},      {"fixed", 0, 0, "sorted"},
+                                               {"fixed", 0, 0, "eytzinger"}, {"fixed", 0, 0, "btree"},
+                                               {"hierarchical"},             {"btree"}};
         
-        std::vector<uint64_t> queries;
-        for (size_t i = 0; i < QUERY_COUNT; ++i) {
-            queries.push_back(id_dist(gen));
+        std::cout << "Specialized Pipeline Results (" << block_count << " blocks, " << queries.size()
+                  << " zipf queries, best of " << REPETITIONS << "):\n";
+        std::cout << "Pipeline,VirtualNsPerOp,SpecializedNsPerOp,Speedup,Match\n";
+        bool all_match = true;
+        for (const std::string model : {"linear", "piecewise", "serpentine"}) {
+            simulator.set_seek_model(model);
+            simulator.set_geometry(model == "serpentine" ? 1024 : 0);
+            for (const std::string cache_policy : {"none", "lru"}) {
+                DeviceCacheConfig cache;
+                cache.policy = cache_policy;
+                cache.capacity_bytes = 4 * 1024 * 1024;
+                cache.read_ahead_blocks = 8;
+                simulator.set_device_cache(cache);
+                
+                for (const auto& config : configs) {
+                    TapeDevice virtual_tape = simulator.get_tape().create_cursor();
+                    TapeDevice specialized_tape = simulator.get_tape().create_cursor();
+                    auto virtual_strategy = IndexStrategyFactory::create_strategy(config.type, 0, 0, config.container);
+                    auto specialized_strategy =
+                        IndexStrategyFactory::create_strategy(config.type, 0, 0, config.container);
+                    virtual_strategy->build_index(virtual_tape);
+                    specialized_strategy->build_index(specialized_tape);
+                    auto pipeline = QueryPipelineFactory::create_pipeline(*specialized_strategy, specialized_tape);
+                    if (!pipeline) {
+                        throw std::logic_error("No specialized pipeline for " + config.type);
+                    }
+                    
+                    std::vector<std::pair<size_t, double>> expected;
+                    std::vector<std::pair<size_t, double>> actual;
+                    double virtual_ns = std::numeric_limits<double>::max();
+                    double specialized_ns = std::numeric_limits<double>::max();
+                    bool match = true;
+                    for (size_t rep = 0; rep < REPETITIONS; ++rep) {
+                        expected.clear();
+                        auto start = Clock::now();
+                        IndexStrategy& strategy = *virtual_strategy;
+                        for (uint64_t id : queries) {
+                            expected.push_back(strategy.find_block(virtual_tape, id));
+                        }
+                        virtual_ns = std::min(virtual_ns,
+                                              std::chrono::duration<double, std::nano>(Clock::now() - start).count());
+                        
+                        start = Clock::now();
+                        pipeline->run(specialized_tape, queries, actual);
+                        specialized_ns = std::min(
+                            specialized_ns, std::chrono::duration<double, std::nano>(Clock::now() - start).count());
+                        match = match && expected == actual;
+                    }
+                    all_match = all_match && match;
+                    std::cout << pipeline->get_name() << ","
+                              << virtual_ns / queries.size() << "," << specialized_ns / queries.size() << ","
+                              << virtual_ns / specialized_ns << "," << (match ? "yes" : "no") << "\n";
+                }
+            }
         }
+        if (!all_match) {
+            std::cerr << "Specialized pipelines disagree with the virtual path" << std::endl;
+            return 1;
+        }
+        std::cout << "Specialized pipelines match virtual path\n";
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
+
+// 索引页格式报告入口：整盘索引打包成页时的页数与解码耗时，以及固定间隔策略写入的索引页规模
+// 并核对只读取索引页重建出的容器与扫描整盘构建的结果一致
+int run_index_format_report(int argc, char** argv) {
+    try {
+        size_t block_count = (argc > 2) ? std::stoull(argv[2]) : 1000000;
+        size_t block_size = (argc > 3) ? std::stoull(argv[3]) : 4096;
+        const size_t DECODE_REPETITIONS = 3;
         
-        std::vector<std::string> strategies = {"none", "fixed", "hierarchical"};
-        
-        std::cout << "Starting tape storage simulation with " << BLOCK_COUNT 
-                  << " blocks and " << QUERY_COUNT << " queries..." << std::endl;
+        TapeSimulator simulator(block_size);
+        simulator.set_payload_mode(PayloadMode::Synthetic);
+        simulator.set_data_seed(1);
+        simulator.generate_tape(block_count);
+        const TapeDevice& tape = simulator.get_tape();
+        std::vector<IndexPageCodec::Entry> entries;
+        entries.reserve(block_count);
+        for (size_t pos = 0; pos < tape.get_block_count(); ++pos) {
+            TapeBlockView block = tape.view_block(pos);
+            if (!block.is_index_block) {
+                entries.emplace_back(block.block_id, pos);
+            }
+        }
+        if (entries.empty()) {
+            throw std::invalid_argument("index-format needs at least one data block");
+        }
+        double per_million = 1e6 / entries.size();
         
-        auto results = simulator.run_comparison(BLOCK_COUNT, queries, strategies);
+        // 整盘索引打包：未压缩布局按每条目16字节计算页数
+        auto pages = IndexPageCodec::encode(entries, block_size);
+        size_t packed_bytes = 0;
+        for (const auto& page : pages) {
+            packed_bytes += page.size();
+        }
+        size_t raw_per_page = (block_size - IndexPageCodec::HEADER_BYTES) / IndexPageCodec::RAW_ENTRY_BYTES;
+        size_t raw_pages = (entries.size() + raw_per_page - 1) / raw_per_page;
         
-        std::cout << "\nSimulation Results:\n" << std::endl;
-        simulator.print_results();
+        std::vector<IndexPageCodec::Entry> decoded;
+        double decode_ns = std::numeric_limits<double>::max();
+        for (size_t rep = 0; rep < DECODE_REPETITIONS; ++rep) {
+            decoded.clear();
+            decoded.reserve(entries.size());
+            auto start = std::chrono::steady_clock::now();
+            for (const auto& page : pages) {
+                IndexPageCodec::decode(page.data(), page.size(), decoded);
+            }
+            decode_ns = std::min(
+                decode_ns, std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count());
+        }
+        std::vector<IndexPageCodec::Entry> sorted_entries = entries;
+        std::sort(sorted_entries.begin(), sorted_entries.end());
+        bool verified = decoded == sorted_entries;
         
-        std::cout << "\nPerformance Analysis:" << std::endl;
-        const auto& no_index = results[0];
+        std::cout << "Packed Index Pages (" << entries.size() << " objects, " << block_size << "-byte pages):\n";
+        std::cout << "Layout,Pages,BytesPerEntry,PagesPerMillion,DecodeNsPerEntry\n";
+        std::cout << std::fixed << std::setprecision(2);
+        std::cout << "raw," << raw_pages << "," << static_cast<double>(IndexPageCodec::RAW_ENTRY_BYTES) << ","
+                  << raw_pages * per_million << ",-\n";
+        std::cout << "delta-varint," << pages.size() << "," << static_cast<double>(packed_bytes) / entries.size()
+                  << "," << pages.size() * per_million << "," << decode_ns / entries.size() << "\n";
         
-        for (size_t i = 1; i < results.size(); ++i) {
-            double speedup = no_index.average_access_time / results[i].average_access_time;
-            std::cout << results[i].strategy_name << " is " 
-                      << std::fixed << std::setprecision(2) << speedup 
-                      << "x faster than no index strategy" << std::endl;
+        // 固定间隔策略：每interval个数据块写一组索引页，之后只读索引页重建容器
+        std::cout << "\nFixed Interval Index Pages:\n";
+        std::cout << "Interval,Placement,IndexPages,IndexBytes,BytesPerEntry,PagesPerMillion,BuildTime(s),"
+                     "LoadTime(s),DecodeNsPerEntry\n";
+        for (size_t interval : {10, 100, 1000}) {
+            for (IndexPlacement placement : {IndexPlacement::End, IndexPlacement::Partition}) {
+                TapeDevice cursor = tape.create_cursor();
+                FixedIntervalIndexStrategy strategy(interval, "sorted");
+                strategy.set_index_placement(placement);
+                if (placement == IndexPlacement::Partition) {
+                    // 每组至少一页，整盘打包的页数是分组跨页的上界
+                    cursor.format_index_partition(entries.size() / interval + pages.size() + 1);
+                }
+                double build_time = strategy.build_index(cursor);
+                std::vector<uint64_t> expected(entries.size());
+                for (size_t i = 0; i < entries.size(); ++i) {
+                    strategy.get_container().find(entries[i].first, expected[i]);
+                }
+                
+                double load_time = strategy.load_index(cursor);
+                for (size_t i = 0; i < entries.size() && verified; ++i) {
+                    uint64_t position = 0;
+                    verified = strategy.get_container().find(entries[i].first, position) && position == expected[i];
+                }
+                
+                const IndexPageStats& stats = strategy.get_page_stats();
+                std::cout << interval << "," << index_placement_name(placement) << "," << stats.pages << ","
+                          << stats.bytes << "," << static_cast<double>(stats.bytes) / stats.entries << ","
+                          << stats.pages * per_million << "," << std::setprecision(6) << build_time << ","
+                          << load_time << "," << std::setprecision(2) << stats.decode_ns / stats.entries << "\n";
+            }
         }
         
+        if (!verified) {
+            std::cerr << "Index pages did not round-trip" << std::endl;
+            return 1;
+        }
+        std::cout << "Index reloaded from tape pages\n";
+        return 0;
     } catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << std::endl;
         return 1;
     }
-    
-    return 0;
 }
 
-// 基准测试入口（供CTest调用）
-int run_benchmarks() {
+// 学习型索引对比入口：批次单调ID与独立随机ID两种磁带上，比较固定间隔、分层与学习型索引的
+// 索引规模、模拟访问时间和主机查找耗时，并核对学习型索引找到每个查询
+int run_learned_comparison(int argc, char** argv) {
     try {
-        const size_t BLOCK_COUNT = 10000;
-        const size_t QUERY_COUNT = 1000;
         const size_t BLOCK_SIZE = 4096;
+        size_t block_count = (argc > 2) ? std::stoull(argv[2]) : 100000;
+        size_t batch_blocks = (argc > 3) ? std::stoull(argv[3]) : 1000;
+        size_t error = (argc > 4) ? std::stoull(argv[4]) : 16;
+        size_t query_count = (argc > 5) ? std::stoull(argv[5]) : 2000;
+        if (batch_blocks == 0) {
+            throw std::invalid_argument("learned needs a batch length of at least one block");
+        }
         
-        TapeSimulator simulator(BLOCK_SIZE);
-        std::vector<std::string> strategies = {"none", "fixed", "hierarchical"};
+        // 分层与学习型索引各加一组常驻全部索引块的配置，排除反复读取索引块的耗时
+        std::vector<StrategyConfig> configs = {
+            {"fixed"},
+            {"hierarchical"},
+            {"hierarchical", 0, 0, "hash", IndexPlacement::End, IndexCachePolicy::PinAll},
+            {"learned", error},
+            {"learned", error, 0, "hash", IndexPlacement::End, IndexCachePolicy::PinAll}};
+        std::cout << "Learned Index Results (" << block_count << " blocks, error " << error << "):\n";
+        std::cout << "Layout,Strategy,IndexCache,IndexBlocks,IndexBytes,MemoryBytes,BuildTime(s),AvgAccessTime(s),"
+                     "HostNsPerLookup\n";
+        bool all_found = true;
+        std::vector<std::string> summaries;
+        for (size_t layout_batch : {batch_blocks, size_t{0}}) {
+            std::string layout = layout_batch > 0 ? "batched-" + std::to_string(layout_batch) : "random";
+            TapeSimulator simulator(BLOCK_SIZE);
+            simulator.set_payload_mode(PayloadMode::Synthetic);
+            simulator.set_data_seed(1);
+            simulator.set_id_batch_blocks(layout_batch);
+            simulator.generate_tape(block_count);
+            std::vector<uint64_t> queries = simulator.sample_stored_ids(query_count, 2);
+            
+            std::vector<SimulationResult> results = simulator.run_parallel_comparison(queries, configs);
+            for (size_t i = 0; i < results.size(); ++i) {
+                const SimulationResult& result = results[i];
+                double host_ns = result.query_timer.calls > 0
+                               ? result.query_timer.host_cpu_ms * 1e6 / result.query_timer.calls : 0.0;
+                std::cout << layout << "," << result.strategy_name << ","
+                          << index_cache_policy_name(configs[i].cache_policy) << "," << result.index_tape_blocks << ","
+                          << result.index_tape_bytes << "," << result.index_memory_bytes << ","
+                          << result.index_build_time << "," << result.average_access_time << "," << host_ns << "\n";
+            }
+            
+            // 逐个核对：每个查询都应在预测窗口内找到ID相同的块
+            TapeDevice cursor = simulator.get_tape().create_cursor();
+            LearnedIndexStrategy learned(error);
+            learned.build_index(cursor);
+            for (uint64_t id : queries) {
+                size_t position = learned.find_block(cursor, id).first;
+                all_found = all_found && position != std::string::npos && cursor.view_block(position).block_id == id;
+            }
+            std::stringstream summary;
+            summary << layout << ": " << learned.get_segment_count() << " segments, "
+                    << learned.average_window_blocks() << " blocks read per window";
+            summaries.push_back(summary.str());
+        }
+        for (const auto& summary : summaries) {
+            std::cout << summary << "\n";
+        }
         
-        // 生成测试查询
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::uniform_int_distribution<uint64_t> id_dist(1, 1000000);
-        std::vector<uint64_t> queries;
-        for (size_t i = 0; i < QUERY_COUNT; ++i) {
-            queries.push_back(id_dist(gen));
+        if (!all_found) {
+            std::cerr << "Learned index missed a stored block" << std::endl;
+            return 1;
         }
+        std::cout << "Learned index found every query\n";
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
 
-        // 输出基准测试结果（CTest会捕获这些输出）
-        std::cout << "Benchmark Results (ms):\n";
-        std::cout << "Strategy,IndexBuildTime,QueryTime\n";
+// 写入吞吐量对比入口：同一批小对象在逐对象记录与合并记录、快慢两种主机速度、两种缓冲区容量、
+// 有无同步点下的有效写入吞吐量与停带次数，并核对写到磁带上的字节数与提交的一致
+int run_ingest_comparison(int argc, char** argv) {
+    try {
+        const size_t BLOCK_SIZE = 4096;
+        const size_t SMALL_BUFFER = 64 * 1024;
+        size_t object_count = (argc > 2) ? std::stoull(argv[2]) : 20000;
+        size_t buffer_kb = (argc > 3) ? std::stoull(argv[3]) : 1024;
+        size_t sync_every = (argc > 4) ? std::stoull(argv[4]) : 1000;
+        
+        // 与generate_tape相同的小对象：长度在1到block_size/2之间均匀分布
+        std::mt19937 gen(1);
+        std::uniform_int_distribution<size_t> size_dist(1, BLOCK_SIZE / 2);
+        std::vector<size_t> sizes(object_count);
+        for (size_t& size : sizes) {
+            size = size_dist(gen);
+        }
+        
+        std::cout << "Ingest Results (" << object_count << " objects, " << BLOCK_SIZE << "-byte blocks):\n";
+        std::cout << "Records,HostKBps,BufferKB,SyncEvery,ThroughputKBps,TapeBlocks,Underruns,SyncStops,"
+                     "Backhitch(s),HostWait(s),Elapsed(s)\n";
+        bool verified = true;
+        const double FAST_HOST = 2048.0 * 1024;
+        const double SLOW_HOST = 384.0 * 1024;
+        size_t slow_small_underruns = 0;  // 慢主机、小缓冲区、合并记录、无同步点时的停带次数
+        double fast_throughput[2] = {0.0, 0.0};  // 快主机、小缓冲区、无同步点时逐对象/合并记录的吞吐量
+        for (bool coalesce : {false, true}) {
+            for (double host_rate : {FAST_HOST, SLOW_HOST}) {
+                for (size_t buffer_bytes : {SMALL_BUFFER, buffer_kb * 1024}) {
+                    for (size_t sync : {size_t{0}, sync_every}) {
+                        TapeDevice tape(BLOCK_SIZE);
+                        tape.set_payload_mode(PayloadMode::Synthetic);
+                        WritePipelineConfig config;
+                        config.coalesce = coalesce;
+                        config.host_rate = host_rate;
+                        config.buffer_bytes = buffer_bytes;
+                        WritePipeline pipeline(tape, config);
+                        for (size_t i = 0; i < sizes.size(); ++i) {
+                            pipeline.submit(i + 1, sizes[i]);
+                            if (sync > 0 && (i + 1) % sync == 0) {
+                                pipeline.sync();
+                            }
+                        }
+                        const WritePipelineStats& stats = pipeline.finish();
+                        verified = verified && tape.get_block_count() == stats.records &&
+                                   tape.get_store().bytes_before(tape.get_block_count()) == stats.payload_bytes;
+                        if (buffer_bytes == SMALL_BUFFER && sync == 0) {
+                            if (host_rate == SLOW_HOST && coalesce) {
+                                slow_small_underruns = stats.underruns;
+                            }
+                            if (host_rate == FAST_HOST) {
+                                fast_throughput[coalesce] = stats.throughput();
+                            }
+                        }
+                        
+                        std::cout << (coalesce ? "coalesced" : "per-object") << "," << host_rate / 1024 << ","
+                                  << buffer_bytes / 1024 << "," << sync << "," << stats.throughput() / 1024 << ","
+                                  << stats.records << "," << stats.underruns << "," << stats.sync_stops << ","
+                                  << stats.backhitch_seconds << "," << stats.host_wait << "," << stats.elapsed
+                                  << "\n";
+                    }
+                }
+            }
+        }
+        
+        if (!verified) {
+            std::cerr << "Tape contents do not match the submitted objects" << std::endl;
+            return 1;
+        }
+        std::cout << "All staged bytes reached tape\n";
+        
+        // 停带模型：慢主机喂不饱小缓冲区时必然停带；快主机下合并记录省去每条记录的间隙，吞吐量更高
+        if (slow_small_underruns == 0 || fast_throughput[1] <= fast_throughput[0]) {
+            std::cerr << "Stall model mismatch: " << slow_small_underruns << " underruns with a slow host, "
+                      << fast_throughput[1] / 1024 << " KB/s coalesced vs " << fast_throughput[0] / 1024
+                      << " KB/s per-object" << std::endl;
+            return 1;
+        }
+        std::cout << "Stall model checked: " << slow_small_underruns << " underruns with a slow host and "
+                  << SMALL_BUFFER / 1024 << " KB buffer, coalesced " << fast_throughput[1] / 1024
+                  << " KB/s vs per-object " << fast_throughput[0] / 1024 << " KB/s\n";
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
 
-        for (const auto& strategy : strategies) {
-            simulator.set_strategy(IndexStrategyFactory::create_strategy(strategy));
-            
-            // 测量索引构建时间
-            double build_time = simulator.benchmark_index_build(BLOCK_COUNT);
+// 对象打包对比入口：同一批小对象按每块一个对象与打包进容器块两种布局写入，
+// 比较空间利用率，以及单对象随机读取和整目录（连续写入的一组对象）读取时每个对象读取的块数与模拟耗时
+int run_packing_comparison(int argc, char** argv) {
+    try {
+        const size_t BLOCK_SIZE = 4096;
+        size_t object_count = (argc > 2) ? std::stoull(argv[2]) : 100000;
+        size_t run_length = (argc > 3) ? std::stoull(argv[3]) : 32;
+        size_t query_count = (argc > 4) ? std::stoull(argv[4]) : 2000;
+        if (object_count == 0 || run_length == 0 || run_length > object_count) {
+            throw std::invalid_argument("packing needs 1 <= run_length <= objects");
+        }
+        
+        // 与generate_tape相同的长度分布，对象ID按写入顺序编号
+        std::mt19937 gen(1);
+        std::uniform_int_distribution<size_t> size_dist(1, BLOCK_SIZE / 2);
+        std::vector<size_t> sizes(object_count);
+        for (size_t& size : sizes) {
+            size = size_dist(gen);
+        }
+        
+        // 每块一个对象：对象ID到块位置的映射即普通的内存索引
+        TapeDevice unpacked(BLOCK_SIZE);
+        unpacked.set_payload_mode(PayloadMode::Synthetic);
+        std::unordered_map<uint64_t, size_t> unpacked_positions;
+        size_t payload_bytes = 0;
+        for (size_t i = 0; i < object_count; ++i) {
+            unpacked_positions[i + 1] = unpacked.get_block_count();
+            unpacked.write_synthetic_block(i + 1, sizes[i]);
+            payload_bytes += sizes[i];
+        }
+        
+        TapeDevice packed(BLOCK_SIZE);
+        packed.set_payload_mode(PayloadMode::Synthetic);
+        ObjectPacker packer(packed);
+        for (size_t i = 0; i < object_count; ++i) {
+            packer.add(i + 1, sizes[i]);
+        }
+        packer.flush();
+        
+        // 核对目录：按写入顺序拼接的字节流中，每个对象紧接在前一个之后
+        bool verified = packer.get_object_count() == object_count && packer.get_payload_bytes() == payload_bytes;
+        
+        // 重复添加：目录指向新版本，旧版本的字节计入被覆盖字节而不是对象字节
+        {
+            TapeDevice scratch(BLOCK_SIZE);
+            scratch.set_payload_mode(PayloadMode::Synthetic);
+            ObjectPacker rewrite(scratch);
+            rewrite.add(1, 100);
+            rewrite.add(1, 300);
+            rewrite.flush();
+            ObjectExtent extent{};
+            verified = verified && rewrite.locate(1, extent) && extent.offset == 100 && extent.length == 300 &&
+                       rewrite.get_payload_bytes() == 300 && rewrite.get_superseded_bytes() == 100;
+        }
+        uint64_t stream_offset = 0;
+        for (size_t i = 0; i < object_count && verified; ++i) {
+            ObjectExtent extent;
+            verified = packer.locate(i + 1, extent) && extent.length == sizes[i] &&
+                       extent.first_block * BLOCK_SIZE + extent.offset == stream_offset;
+            stream_offset += sizes[i];
+        }
+        
+        // 随机读取单个对象；目录读取一次请求run_length个连续写入的对象
+        std::mt19937_64 query_gen(2);
+        std::uniform_int_distribution<uint64_t> start_dist(1, object_count - run_length + 1);
+        std::vector<std::vector<uint64_t>> random_requests(query_count);
+        std::vector<std::vector<uint64_t>> directory_requests(std::max<size_t>(1, query_count / run_length));
+        for (auto& request : random_requests) {
+            request.push_back(start_dist(query_gen));
+        }
+        for (auto& request : directory_requests) {
+            uint64_t first = start_dist(query_gen);
+            for (uint64_t id = first; id < first + run_length; ++id) {
+                request.push_back(id);
+            }
+        }
+        
+        double unpacked_efficiency = static_cast<double>(payload_bytes) / (object_count * BLOCK_SIZE);
+        size_t unpacked_directory_bytes =
+            unpacked_positions.size() * (sizeof(std::pair<const uint64_t, size_t>) + 2 * sizeof(void*)) +
+            unpacked_positions.bucket_count() * sizeof(void*);
+        std::cout << "Packing Results (" << object_count << " objects, " << BLOCK_SIZE << "-byte blocks, "
+                  << "directory reads of " << run_length << " objects):\n";
+        std::cout << "Layout,Workload,TapeBlocks,SpaceEfficiency,DirectoryBytesPerObject,BlocksReadPerObject,"
+                     "AvgTimePerObject(s)\n";
+        struct Measured {
+            double blocks_per_object;
+            double time_per_object;
+        };
+        std::vector<Measured> measured;
+        for (const auto* requests : {&random_requests, &directory_requests}) {
+            std::string workload = requests == &random_requests ? "random" : "directory";
             
-            // 测量查询时间
-            double query_time = simulator.benchmark_queries(queries);
+            // 每块一个对象：请求内的块按位置排序后逐个读取
+            TapeDevice cursor = unpacked.create_cursor();
+            size_t objects = 0;
+            size_t blocks_read = 0;
+            double time = 0.0;
+            for (const auto& request : *requests) {
+                std::vector<size_t> positions;
+                for (uint64_t id : request) {
+                    positions.push_back(unpacked_positions.at(id));
+                }
+                std::sort(positions.begin(), positions.end());
+                for (size_t position : positions) {
+                    time += cursor.seek_to_block(position);
+                    time += cursor.view_current_block().second;
+                }
+                objects += request.size();
+                blocks_read += positions.size();
+            }
+            measured.push_back({static_cast<double>(blocks_read) / objects, time / objects});
+            std::cout << "unpacked," << workload << "," << unpacked.get_block_count() << "," << unpacked_efficiency
+                      << "," << static_cast<double>(unpacked_directory_bytes) / object_count << ","
+                      << measured.back().blocks_per_object << "," << measured.back().time_per_object << "\n";
             
-            // 输出CSV格式，便于CTest解析
-            std::cout << strategy << "," << build_time << "," << query_time << "\n";
+            TapeDevice packed_cursor = packed.create_cursor();
+            PackedReadStats total;
+            objects = 0;
+            for (const auto& request : *requests) {
+                PackedReadStats stats = packer.read_objects(packed_cursor, request);
+                verified = verified && stats.objects_found == request.size();
+                total.blocks_read += stats.blocks_read;
+                total.time += stats.time;
+                objects += request.size();
+            }
+            measured.push_back({static_cast<double>(total.blocks_read) / objects, total.time / objects});
+            std::cout << "packed," << workload << "," << packer.get_block_count() << "," << packer.space_efficiency()
+                      << "," << static_cast<double>(packer.memory_bytes()) / object_count << ","
+                      << measured.back().blocks_per_object << "," << measured.back().time_per_object << "\n";
         }
-
+        
+        std::cout << "Space efficiency: " << unpacked_efficiency * 100 << "% unpacked, "
+                  << packer.space_efficiency() * 100 << "% packed\n";
+        std::cout << "Blocks read per object: random " << measured[0].blocks_per_object << " -> "
+                  << measured[1].blocks_per_object << ", directory " << measured[2].blocks_per_object << " -> "
+                  << measured[3].blocks_per_object << "\n";
+        if (!verified) {
+            std::cerr << "Packed object directory is inconsistent" << std::endl;
+            return 1;
+        }
+        std::cout << "All packed objects located\n";
         return 0;
     } catch (const std::exception& e) {
-        std::cerr << "Benchmark failed: " << e.what() << std::endl;
+        std::cerr << "Error: " << e.what() << std::endl;
         return 1;
     }
-}
\ No newline at end of file
+}